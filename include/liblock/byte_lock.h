@@ -0,0 +1,77 @@
+#ifndef BYTE_LOCK_H
+#define BYTE_LOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// A one-byte blocking lock built on the parking lot, in the style of WebKit's WTF::Lock.
+//
+// Only two bits are used: held, and "a thread may be parked on this lock". The
+// uncontended paths are a single CAS. A contender spins briefly while nobody is
+// parked, then parks on the lock's address. Unlock normally releases the lock
+// and lets the woken thread compete with newcomers, which keeps throughput high;
+// about once a millisecond it instead hands the lock directly to the woken
+// thread, so sustained contention cannot starve a parked waiter.
+
+#define BYTE_LOCK_HELD   0x1u
+#define BYTE_LOCK_PARKED 0x2u
+#define BYTE_LOCK_SPINS  40 // Yielding spins before a contender parks
+
+typedef struct {
+    uint8_t state; // Accessed only through __atomic builtins
+} byte_lock_t;
+
+#define BYTE_LOCK_INIT { 0 }
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Contended acquire path. Called by byte_lock_lock() after its CAS fails.
+ */
+void byte_lock_lock_slow(byte_lock_t *lock);
+
+/**
+ * @brief Release path when a thread may be parked. Called by byte_lock_unlock() after its CAS fails.
+ */
+void byte_lock_unlock_slow(byte_lock_t *lock);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline void byte_lock_init(byte_lock_t *lock) {
+    __atomic_store_n(&lock->state, 0, __ATOMIC_RELAXED);
+}
+
+static inline bool byte_lock_trylock(byte_lock_t *lock) {
+    uint8_t state = __atomic_load_n(&lock->state, __ATOMIC_RELAXED);
+    while (!(state & BYTE_LOCK_HELD)) {
+        if (__atomic_compare_exchange_n(&lock->state, &state, (uint8_t) (state | BYTE_LOCK_HELD), true,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline void byte_lock_lock(byte_lock_t *lock) {
+    uint8_t expected = 0;
+    if (__builtin_expect(__atomic_compare_exchange_n(&lock->state, &expected, BYTE_LOCK_HELD, false,
+                                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED), 1)) {
+        return;
+    }
+    byte_lock_lock_slow(lock);
+}
+
+static inline void byte_lock_unlock(byte_lock_t *lock) {
+    uint8_t expected = BYTE_LOCK_HELD;
+    if (__builtin_expect(__atomic_compare_exchange_n(&lock->state, &expected, 0, false,
+                                                     __ATOMIC_RELEASE, __ATOMIC_RELAXED), 1)) {
+        return;
+    }
+    byte_lock_unlock_slow(lock);
+}
+
+#endif // BYTE_LOCK_H
@@ -0,0 +1,66 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+// Epoch-based memory reclamation for lock-free readers.
+//
+// Readers bracket every access to shared, lock-free data with epoch_enter() /
+// epoch_exit(). Writers unlink an object so no new reader can reach it, then
+// hand it to epoch_retire(); it is freed once every reader that might still
+// hold a reference has left its read-side section.
+//
+// Threads register themselves on first use and unregister when they exit.
+// Reclamation is amortized: every EPOCH_RECLAIM_EVERY retires the retiring
+// thread tries to advance the global epoch and frees whatever became safe.
+
+#define EPOCH_RECLAIM_EVERY 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*epoch_free_fn)(void *ptr);
+
+/**
+ * @brief Registers the calling thread. Optional: epoch_enter() and epoch_retire() register lazily.
+ */
+void epoch_register_thread(void);
+
+/**
+ * @brief Releases the calling thread's record before it exits.
+ * Objects it retired but that are not yet safe to free are handed to the other threads.
+ * Must not be called inside a read-side section.
+ */
+void epoch_unregister_thread(void);
+
+/**
+ * @brief Begins a read-side section. Sections nest.
+ */
+void epoch_enter(void);
+
+/**
+ * @brief Ends the read-side section begun by the matching epoch_enter().
+ */
+void epoch_exit(void);
+
+/**
+ * @brief Defers free_fn(ptr) until no reader can still be accessing ptr.
+ * ptr must already be unreachable for new readers. May be called inside a read-side section.
+ */
+void epoch_retire(void *ptr, epoch_free_fn free_fn);
+
+/**
+ * @brief Tries to advance the epoch and frees whatever became safe. Never blocks.
+ */
+void epoch_reclaim(void);
+
+/**
+ * @brief Waits until everything the calling thread has retired so far has been freed.
+ * Must not be called inside a read-side section.
+ */
+void epoch_barrier(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EPOCH_H
@@ -0,0 +1,98 @@
+#ifndef GUARDED_H
+#define GUARDED_H
+
+#include "lock.h"
+#include "byte_lock.h"
+#include "qspinlock.h"
+#include <stddef.h>
+
+// Guarded data for C: a lock and the value it protects, laid out by policy.
+//
+//   typedef GUARDED_QSPIN(struct stats, SHARED_LINE) guarded_stats_t;
+//   guarded_stats_t g;
+//   guarded_qspin_init(&g);
+//   WITH_GUARDED_QSPIN(&g, s) { s->hits++; }
+//
+// SHARED_LINE packs the lock and the data from the start of one cache line, so
+// an uncontended critical section touches a single line. SEPARATE_LINES gives
+// the data its own line, so threads waiting on the lock do not steal the line
+// the holder is writing. Either way the struct is padded to whole cache lines,
+// so it never shares a line with its neighbours.
+//
+// GUARDED_QSPIN and GUARDED_BYTE_LOCK embed a qspinlock_t or byte_lock_t, so the
+// layout places the lock word itself. GUARDED holds a lock_t from the factory,
+// whose state lives on the heap; there the layout only places the pointer.
+
+#define GUARDED_CACHE_LINE 64
+
+#define GUARDED_SHARED_LINE(L, T)                                           \
+    struct __attribute__((aligned(GUARDED_CACHE_LINE))) {                  \
+        L lock;                                                             \
+        T data;                                                             \
+    }
+
+#define GUARDED_SEPARATE_LINES(L, T)                                        \
+    struct __attribute__((aligned(GUARDED_CACHE_LINE))) {                  \
+        L lock;                                                             \
+        T data __attribute__((aligned(GUARDED_CACHE_LINE)));               \
+    }
+
+// Declares an anonymous guarded struct type; layout is SHARED_LINE or SEPARATE_LINES.
+#define GUARDED(T, layout) GUARDED_##layout(lock_t *, T)
+#define GUARDED_QSPIN(T, layout) GUARDED_##layout(qspinlock_t, T)
+#define GUARDED_BYTE_LOCK(T, layout) GUARDED_##layout(byte_lock_t, T)
+
+// Creates the lock. Returns false if the lock could not be created.
+#define guarded_init(g, type) (((g)->lock = create_lock_object(type)) != NULL)
+
+#define guarded_destroy(g) (destroy_lock_object((g)->lock), (g)->lock = NULL)
+
+// Inline locks need no teardown.
+#define guarded_qspin_init(g) qspin_init(&(g)->lock)
+#define guarded_byte_lock_init(g) byte_lock_init(&(g)->lock)
+
+static inline lock_t *guarded_acquire_(lock_t *l, const char *file, int line) {
+    l->_lock(l, file, line);
+    return l;
+}
+
+static inline void guarded_release_(lock_t **l) {
+    (*l)->unlock(*l);
+}
+
+static inline qspinlock_t *guarded_qspin_acquire_(qspinlock_t *l) {
+    qspin_lock(l);
+    return l;
+}
+
+static inline void guarded_qspin_release_(qspinlock_t **l) {
+    qspin_unlock(*l);
+}
+
+static inline byte_lock_t *guarded_byte_lock_acquire_(byte_lock_t *l) {
+    byte_lock_lock(l);
+    return l;
+}
+
+static inline void guarded_byte_lock_release_(byte_lock_t **l) {
+    byte_lock_unlock(*l);
+}
+
+#define GUARDED_WITH_(L, acquire, release, g, var)                                               \
+    for (L *guarded_held_ __attribute__((cleanup(release))) = (acquire),                          \
+           *guarded_once_ = guarded_held_;                                                        \
+         guarded_once_; guarded_once_ = NULL)                                                     \
+        for (__typeof__((g)->data) *var = &(g)->data; guarded_once_; guarded_once_ = NULL)
+
+// Runs the following statement or block with the lock held and var pointing at the data.
+// The lock is released however the block is left, including return and goto. The macro
+// expands to hidden for loops, so break and continue inside the block leave the block
+// itself, not an enclosing loop; set a flag and test it after the block to leave that.
+#define WITH_GUARDED(g, var) \
+    GUARDED_WITH_(lock_t, guarded_acquire_((g)->lock, __FILE__, __LINE__), guarded_release_, g, var)
+#define WITH_GUARDED_QSPIN(g, var) \
+    GUARDED_WITH_(qspinlock_t, guarded_qspin_acquire_(&(g)->lock), guarded_qspin_release_, g, var)
+#define WITH_GUARDED_BYTE_LOCK(g, var) \
+    GUARDED_WITH_(byte_lock_t, guarded_byte_lock_acquire_(&(g)->lock), guarded_byte_lock_release_, g, var)
+
+#endif // GUARDED_H
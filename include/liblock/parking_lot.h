@@ -0,0 +1,58 @@
+#ifndef PARKING_LOT_H
+#define PARKING_LOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// A global parking lot keyed by address, in the style of WebKit's WTF::ParkingLot.
+//
+// Any address can be parked on. The wait queues live in a fixed, hashed table
+// of buckets, so the parked-on object needs no storage of its own beyond a bit
+// that remembers someone may be waiting. Validation and unpark callbacks run
+// under the bucket lock, which lets a lock built on top update its state word
+// atomically with respect to threads that are about to park.
+
+#define PARKING_LOT_BUCKETS 1024
+#define PARKING_LOT_FAIR_INTERVAL_NS 1000000ull // Mean time between "be fair" unparks per bucket
+
+typedef struct {
+    bool did_unpark_thread;
+    bool may_have_more_threads; // Another thread is still parked on the same address
+    bool time_to_be_fair;       // Set roughly once per PARKING_LOT_FAIR_INTERVAL_NS per bucket
+} parking_unpark_result_t;
+
+// Runs under the bucket lock before parking; returning false aborts the park.
+typedef bool (*parking_validate_fn)(void *ctx);
+
+// Runs under the bucket lock after the waiter is dequeued; its return value is handed
+// to the woken thread as the park token.
+typedef intptr_t (*parking_unpark_fn)(parking_unpark_result_t result, void *ctx);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Parks the calling thread on addr if validate(ctx) still holds.
+ * @param validate May be NULL to park unconditionally.
+ * @param token Receives the value returned by the unparker's callback; may be NULL.
+ * @return true once the thread has been unparked, false if validation failed.
+ */
+bool parking_lot_park(const void *addr, parking_validate_fn validate, void *ctx, intptr_t *token);
+
+/**
+ * @brief Wakes the longest-parked thread on addr, if any.
+ * @param callback Runs under the bucket lock whether or not a thread was found; may be NULL.
+ */
+parking_unpark_result_t parking_lot_unpark_one(const void *addr, parking_unpark_fn callback, void *ctx);
+
+/**
+ * @brief Wakes every thread parked on addr and returns how many there were.
+ */
+unsigned parking_lot_unpark_all(const void *addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARKING_LOT_H
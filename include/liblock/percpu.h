@@ -0,0 +1,129 @@
+#ifndef PERCPU_H
+#define PERCPU_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lock_types.h"
+
+// Per-CPU data updated inside restartable sequences (rseq).
+//
+// A percpu_t holds one cache-line-padded slot per possible CPU, each with a
+// word and a singly linked list. An update only ever touches the slot of the
+// CPU the caller is running on. On Linux x86-64, the update runs as an rseq
+// critical section: the kernel restarts it if the thread is preempted,
+// migrated or interrupted by a signal before its single committing store, so
+// add, compare-and-store, push and pop need no atomic instructions and no lock.
+//
+// Threads are registered for rseq on first use. glibc 2.35+ already registers
+// every thread; its area is shared rather than replaced. Where rseq is not
+// available, each slot is instead protected by its own lock of a caller-chosen
+// lock_type_t, which is almost never contended.
+//
+// The mode is fixed when the object is created. In rseq mode every thread
+// that touches the object must be able to register, which holds whenever the
+// creating thread could. rseq mode also needs /sys/devices/system/cpu/possible
+// to size the slots by the highest possible CPU id.
+
+typedef enum {
+    PERCPU_MODE_AUTO,   // rseq when the calling thread can register and the possible CPUs are known, locked otherwise (create only)
+    PERCPU_MODE_RSEQ,   // Updates are rseq critical sections
+    PERCPU_MODE_LOCKED  // Updates take the slot's fallback lock
+} percpu_mode_t;
+
+typedef struct percpu_node_s {
+    struct percpu_node_s *next; // Must stay the first member: the rseq pop reads it at offset 0
+} percpu_node_t;
+
+typedef struct percpu_s percpu_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Registers the calling thread for rseq. Updates call this on demand.
+ * @return true if rseq critical sections can run on this thread.
+ */
+bool percpu_register_thread(void);
+
+/**
+ * @brief Drops a registration made by percpu_register_thread(); a no-op when the area belongs to glibc.
+ * Must be called before the thread's TLS goes away in code that is unloaded while threads keep running.
+ */
+void percpu_unregister_thread(void);
+
+/**
+ * @brief The CPU the calling thread is running on, read from the rseq area when registered.
+ */
+int percpu_current_cpu(void);
+
+/**
+ * @brief One more than the highest possible CPU id, from /sys/devices/system/cpu/possible.
+ * CPU ids can be sparse, so this may exceed the number of CPUs.
+ * @return The count, or -1 if the mask cannot be read.
+ */
+int percpu_possible_cpus(void);
+
+/**
+ * @brief Creates per-CPU data with zeroed words and empty lists.
+ * @param fallback Lock type for each slot in locked mode.
+ * @param mode PERCPU_MODE_AUTO, or PERCPU_MODE_LOCKED to skip rseq. PERCPU_MODE_RSEQ fails if rseq or the possible-CPU mask is unavailable.
+ * @return The object, or NULL on failure.
+ */
+percpu_t *percpu_create(lock_type_t fallback, percpu_mode_t mode);
+
+void percpu_destroy(percpu_t *pc);
+
+/**
+ * @brief The mode chosen at creation: PERCPU_MODE_RSEQ or PERCPU_MODE_LOCKED.
+ */
+percpu_mode_t percpu_mode(percpu_t *pc);
+
+/**
+ * @brief The number of slots. In rseq mode, one more than the highest possible CPU id.
+ */
+int percpu_nr_cpus(percpu_t *pc);
+
+/**
+ * @brief Adds delta to the current CPU's word.
+ */
+void percpu_add(percpu_t *pc, intptr_t delta);
+
+/**
+ * @brief Stores newv into the current CPU's word if it equals expect.
+ * @return true if the store happened.
+ */
+bool percpu_cmpstore(percpu_t *pc, intptr_t expect, intptr_t newv);
+
+/**
+ * @brief Reads one CPU's word without synchronizing with updates.
+ */
+intptr_t percpu_word(percpu_t *pc, int cpu);
+
+/**
+ * @brief Sum of all words. Updates that race with the read may be missed.
+ */
+intptr_t percpu_sum(percpu_t *pc);
+
+/**
+ * @brief Pushes node onto the current CPU's list.
+ */
+void percpu_push(percpu_t *pc, percpu_node_t *node);
+
+/**
+ * @brief Pops from the current CPU's list.
+ * @return The node, or NULL if that list is empty. Other CPUs' lists are not searched.
+ */
+percpu_node_t *percpu_pop(percpu_t *pc);
+
+/**
+ * @brief Detaches and returns a whole CPU's list.
+ * In rseq mode this is only safe while no other thread is using pc, e.g. at teardown.
+ */
+percpu_node_t *percpu_drain(percpu_t *pc, int cpu);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PERCPU_H
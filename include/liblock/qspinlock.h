@@ -0,0 +1,90 @@
+#ifndef QSPINLOCK_H
+#define QSPINLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// A four-byte queued spinlock in the style of the Linux kernel qspinlock.
+//
+// The whole lock is one 32-bit word that can be embedded in any object:
+//
+//   bits  0-7   locked byte
+//   bit   8     pending (a single waiter spinning on the word itself)
+//   bits 16-17  tail nesting index
+//   bits 18-31  tail thread slot + 1
+//
+// The uncontended path is a single CAS. A second contender spins on the word
+// via the pending bit; from the third on, waiters queue MCS-style on per-thread
+// nodes, so the lock scales like MCS under contention without storing any
+// queue state of its own. Waiters spin briefly and then yield, so a preempted
+// holder or predecessor can run on an oversubscribed host.
+//
+// The node table is allocated on first contention, with QSPIN_SLOTS_PER_CPU
+// rows per possible CPU. A thread keeps its row until it exits; threads that
+// find every row taken wait on the word instead of queueing.
+
+#define QSPIN_LOCKED_VAL   (1u << 0)
+#define QSPIN_LOCKED_MASK  0xffu
+#define QSPIN_PENDING_VAL  (1u << 8)
+#define QSPIN_TAIL_IDX_SHIFT 16
+#define QSPIN_TAIL_IDX_BITS  2
+#define QSPIN_TAIL_SLOT_SHIFT (QSPIN_TAIL_IDX_SHIFT + QSPIN_TAIL_IDX_BITS)
+#define QSPIN_TAIL_MASK    (~0u << QSPIN_TAIL_IDX_SHIFT)
+// Nodes per row. A node is only held while its thread waits in the slow path, so
+// this bounds slow-path waits nested inside one another (a signal handler that
+// contends while its thread is queued), not how many locks a thread holds.
+#define QSPIN_MAX_NESTING  (1 << QSPIN_TAIL_IDX_BITS)
+#define QSPIN_MAX_THREADS  4096 // Upper bound on node table rows
+#define QSPIN_SLOTS_PER_CPU 4   // Node table rows per possible CPU
+#define QSPIN_SPINS        64   // Pause iterations before a waiter starts yielding
+
+typedef struct {
+    uint32_t val; // Accessed only through __atomic builtins so the locked byte can be released on its own
+} qspinlock_t;
+
+#define QSPINLOCK_INIT { 0 }
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Contended acquire path. Called by qspin_lock() after its CAS fails.
+ * @param val The lock word observed by the failed CAS.
+ */
+void qspin_lock_slowpath(qspinlock_t *lock, uint32_t val);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline void qspin_init(qspinlock_t *lock) {
+    __atomic_store_n(&lock->val, 0, __ATOMIC_RELAXED);
+}
+
+static inline bool qspin_trylock(qspinlock_t *lock) {
+    uint32_t expected = __atomic_load_n(&lock->val, __ATOMIC_RELAXED);
+    if (expected != 0) return false;
+    return __atomic_compare_exchange_n(&lock->val, &expected, QSPIN_LOCKED_VAL, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static inline void qspin_lock(qspinlock_t *lock) {
+    uint32_t expected = 0;
+    if (__builtin_expect(__atomic_compare_exchange_n(&lock->val, &expected, QSPIN_LOCKED_VAL, false,
+                                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED), 1)) {
+        return;
+    }
+    qspin_lock_slowpath(lock, expected);
+}
+
+static inline void qspin_unlock(qspinlock_t *lock) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // Only the holder writes the locked byte, so a plain release store suffices.
+    __atomic_store_n((uint8_t *) &lock->val, 0, __ATOMIC_RELEASE);
+#else
+    __atomic_fetch_sub(&lock->val, QSPIN_LOCKED_VAL, __ATOMIC_RELEASE);
+#endif
+}
+
+#endif // QSPINLOCK_H
@@ -0,0 +1,55 @@
+#ifndef RCL_H
+#define RCL_H
+
+// Remote core locking: a dedicated server thread runs every critical section.
+//
+// Instead of taking a lock, a client writes the critical section (a function
+// and its argument) into its own cache-line-padded mailbox on the server and
+// waits for the result. The server, optionally pinned to one CPU, polls the
+// mailboxes and runs the requests one at a time, so the protected data stays
+// in that core's caches and never migrates between clients.
+//
+// When the server finds nothing to do for RCL_IDLE_SCANS passes it either keeps
+// polling (yielding the CPU between passes) or parks on a futex until a client
+// posts, depending on the idle policy chosen at creation.
+
+#define RCL_MAX_CLIENTS 256 // Threads that can have a request posted at once; others wait for a slot
+#define RCL_IDLE_SCANS 256  // Empty passes over the mailboxes before the idle policy kicks in
+
+typedef enum {
+    RCL_IDLE_POLL, // Keep scanning; lowest latency, but the server's CPU is never released
+    RCL_IDLE_PARK  // Sleep until the next request; clients pay a wakeup after idle periods
+} rcl_idle_t;
+
+typedef void *(*rcl_fn_t)(void *arg);
+
+typedef struct rcl_server_s rcl_server_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Starts a server thread.
+ * @param cpu CPU to pin the server to, or -1 to leave it unpinned.
+ * @param idle What the server does when no requests are pending.
+ * @return The server, or NULL if it could not be created or pinned.
+ */
+rcl_server_t *rcl_server_create(int cpu, rcl_idle_t idle);
+
+/**
+ * @brief Stops and joins the server thread. No client may be inside rcl_execute().
+ */
+void rcl_server_destroy(rcl_server_t *server);
+
+/**
+ * @brief Runs fn(arg) on the server thread and returns its result.
+ * Calls made from inside a critical section of the same server run inline.
+ */
+void *rcl_execute(rcl_server_t *server, rcl_fn_t fn, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RCL_H
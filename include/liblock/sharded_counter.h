@@ -0,0 +1,61 @@
+#ifndef SHARDED_COUNTER_H
+#define SHARDED_COUNTER_H
+
+#include <stdint.h>
+
+// A sharded counter for statistics, reference counts and quotas that would
+// otherwise be a shared integer behind a lock.
+//
+// Every CPU gets its own cache-line-padded slot, so sharded_counter_add() is
+// one uncontended atomic add. sharded_counter_read_exact() includes every add
+// that completed before it was called.
+//
+// With a non-zero batch, a slot whose value reaches +/-batch is folded into
+// the central count, and sharded_counter_read() returns just that count: one
+// load, off by less than batch per slot. sharded_counter_compare() answers
+// quota checks from it unless the counter is within that error of the limit.
+// With a zero batch nothing is folded and sharded_counter_read() sums the
+// slots without locking, which may miss adds that race with it.
+
+#define SHARDED_COUNTER_MAX_SHARDS 256
+#define SHARDED_COUNTER_CPU_REFRESH 256 // Adds between re-reading the calling thread's CPU
+
+typedef struct sharded_counter_s sharded_counter_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Creates a counter with one slot per CPU, starting at zero.
+ * @param batch Slot magnitude at which the slot is folded into the central count; 0 never folds.
+ * @return The counter, or NULL on allocation failure.
+ */
+sharded_counter_t *sharded_counter_create(int64_t batch);
+
+void sharded_counter_destroy(sharded_counter_t *counter);
+
+void sharded_counter_add(sharded_counter_t *counter, int64_t delta);
+
+/**
+ * @brief Approximate value: the central count, off by less than batch * slots.
+ * With a zero batch, a lock-free sum of the slots that may miss racing adds.
+ */
+int64_t sharded_counter_read(sharded_counter_t *counter);
+
+/**
+ * @brief Sum that includes every add completed before the call. Serializes with folds.
+ */
+int64_t sharded_counter_read_exact(sharded_counter_t *counter);
+
+/**
+ * @brief Compares the counter with rhs, returning -1, 0 or 1.
+ * Uses the central count when its error bound keeps the answer certain, otherwise an exact read.
+ */
+int sharded_counter_compare(sharded_counter_t *counter, int64_t rhs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SHARDED_COUNTER_H
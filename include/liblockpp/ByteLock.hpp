@@ -0,0 +1,71 @@
+#ifndef BYTE_LOCK_HPP
+#define BYTE_LOCK_HPP
+
+#include <cstdint>
+
+/**
+ * @brief A one-byte blocking lock built on ParkingLot, in the style of WebKit's WTF::Lock.
+ *
+ * Only two bits are used: held, and "a thread may be parked on this lock". The
+ * uncontended paths are a single CAS. A contender spins briefly while nobody is
+ * parked, then parks on the lock's address. Unlock normally releases the lock
+ * and lets the woken thread compete with newcomers; about once a millisecond it
+ * instead hands the lock directly to the woken thread, so sustained contention
+ * cannot starve a parked waiter.
+ *
+ * Satisfies the standard Lockable requirements, so it works with
+ * std::lock_guard and std::unique_lock.
+ */
+class ByteLock {
+public:
+    ByteLock() = default;
+
+    ByteLock(const ByteLock &) = delete;
+    ByteLock &operator=(const ByteLock &) = delete;
+
+    void lock() {
+        std::uint8_t expected = 0;
+        if (__builtin_expect(__atomic_compare_exchange_n(&_state, &expected, kHeld, false,
+                                                         __ATOMIC_ACQUIRE, __ATOMIC_RELAXED), 1)) {
+            return;
+        }
+        lockSlow();
+    }
+
+    void unlock() {
+        std::uint8_t expected = kHeld;
+        if (__builtin_expect(__atomic_compare_exchange_n(&_state, &expected, 0, false,
+                                                         __ATOMIC_RELEASE, __ATOMIC_RELAXED), 1)) {
+            return;
+        }
+        unlockSlow();
+    }
+
+    bool trylock() {
+        std::uint8_t state = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+        while (!(state & kHeld)) {
+            if (__atomic_compare_exchange_n(&_state, &state, static_cast<std::uint8_t>(state | kHeld), true,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool try_lock() { return trylock(); }
+
+private:
+    static constexpr std::uint8_t kHeld = 0x1;
+    static constexpr std::uint8_t kParked = 0x2;
+    static constexpr int kSpins = 40; // Yielding spins before a contender parks
+
+    void lockSlow();
+    void unlockSlow();
+
+    // Accessed only through __atomic builtins.
+    std::uint8_t _state = 0;
+};
+
+static_assert(sizeof(ByteLock) == 1, "ByteLock must stay a single byte");
+
+#endif // BYTE_LOCK_HPP
@@ -0,0 +1,83 @@
+#ifndef EPOCH_HPP
+#define EPOCH_HPP
+
+/**
+ * @brief Epoch-based memory reclamation for lock-free readers.
+ *
+ * Readers bracket every access to shared, lock-free data with an Epoch::Guard
+ * (or enter()/exit()). Writers unlink an object so no new reader can reach it,
+ * then hand it to retire(); it is destroyed once every reader that might still
+ * hold a reference has left its read-side section.
+ *
+ * Threads register themselves on first use and unregister when they exit.
+ * Reclamation is amortized: every kReclaimEvery retires the retiring thread
+ * tries to advance the global epoch and frees whatever became safe.
+ */
+class Epoch {
+public:
+    using FreeFn = void (*)(void *);
+
+    static constexpr unsigned int kReclaimEvery = 64;
+
+    Epoch() = delete;
+
+    /**
+     * @brief Registers the calling thread. Optional: enter() and retire() register lazily.
+     */
+    static void registerThread();
+
+    /**
+     * @brief Releases the calling thread's record before it exits.
+     * Must not be called inside a read-side section.
+     */
+    static void unregisterThread();
+
+    /**
+     * @brief Begins a read-side section. Sections nest.
+     */
+    static void enter();
+
+    /**
+     * @brief Ends the read-side section begun by the matching enter().
+     */
+    static void exit();
+
+    /**
+     * @brief Defers free_fn(ptr) until no reader can still be accessing ptr.
+     * ptr must already be unreachable for new readers. May be called inside a read-side section.
+     */
+    static void retire(void *ptr, FreeFn free_fn);
+
+    /**
+     * @brief Defers `delete ptr` until no reader can still be accessing it.
+     */
+    template <typename T>
+    static void retire(T *ptr) {
+        retire(static_cast<void *>(ptr), [](void *p) { delete static_cast<T *>(p); });
+    }
+
+    /**
+     * @brief Tries to advance the epoch and frees whatever became safe. Never blocks.
+     */
+    static void reclaim();
+
+    /**
+     * @brief Waits until everything the calling thread has retired so far has been freed.
+     * Must not be called inside a read-side section.
+     */
+    static void barrier();
+
+    /**
+     * @brief RAII read-side section.
+     */
+    class Guard {
+    public:
+        Guard() { Epoch::enter(); }
+        ~Guard() { Epoch::exit(); }
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+    };
+};
+
+#endif // EPOCH_HPP
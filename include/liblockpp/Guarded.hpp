@@ -0,0 +1,157 @@
+#ifndef GUARDED_HPP
+#define GUARDED_HPP
+
+#include "ILock.hpp"
+#include "QSpinLock.hpp"
+#include <cstddef>
+#include <memory>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Layout policies for Guarded.
+ *
+ * LayoutSharedLine packs the lock and the data from the start of one cache line,
+ * so an uncontended critical section touches a single line. LayoutSeparateLines
+ * gives the data its own line, so threads spinning on the lock do not steal the
+ * line the holder is writing. Either way the whole Guarded object is padded to
+ * whole cache lines, so it never shares a line with its neighbours.
+ */
+struct LayoutSharedLine {};
+struct LayoutSeparateLines {};
+
+/**
+ * @brief Lock policy that embeds a lock from the createLock() factory.
+ *
+ * The ILock itself lives on the heap; the policy only stores the pointer, which
+ * every critical section reads and which therefore sits next to or away from the
+ * data according to the layout.
+ */
+template <lock_type_t Type>
+class FactoryLock {
+public:
+    FactoryLock() : _lock(createLock(Type)) {}
+
+    void lock() { _lock->lock(); }
+    void unlock() { _lock->unlock(); }
+    bool try_lock() { return _lock->trylock(); }
+
+private:
+    std::unique_ptr<ILock> _lock;
+};
+
+/**
+ * @brief A value of type T that can only be reached while its lock is held.
+ *
+ * Access goes through RAII handles: with_lock() runs a callable on the data,
+ * write() returns an exclusive handle and read() a const handle. When the lock
+ * policy provides lock_shared()/unlock_shared(), read() holds the lock shared.
+ *
+ * @tparam T The protected data.
+ * @tparam LockPolicy A default-constructible Lockable embedded by value.
+ * @tparam Layout LayoutSharedLine or LayoutSeparateLines.
+ */
+template <typename T, typename LockPolicy = QSpinLock, typename Layout = LayoutSharedLine>
+class alignas(64) Guarded {
+    static_assert(std::is_same<Layout, LayoutSharedLine>::value || std::is_same<Layout, LayoutSeparateLines>::value,
+                  "Layout must be LayoutSharedLine or LayoutSeparateLines");
+
+    template <typename L, typename = void>
+    struct IsSharedLockable : std::false_type {};
+
+    template <typename L>
+    struct IsSharedLockable<L, std::void_t<decltype(std::declval<L &>().lock_shared()),
+                                           decltype(std::declval<L &>().unlock_shared())> > : std::true_type {};
+
+    static constexpr bool kShared = IsSharedLockable<LockPolicy>::value;
+    static constexpr std::size_t kDataAlign =
+        std::is_same<Layout, LayoutSeparateLines>::value ? 64 : alignof(T);
+
+    template <typename U, bool SharedHold>
+    class Handle {
+    public:
+        Handle(U &data, LockPolicy &lock) : _data(&data), _lock(&lock) {}
+
+        Handle(Handle &&other) noexcept : _data(std::exchange(other._data, nullptr)), _lock(other._lock) {}
+
+        Handle(const Handle &) = delete;
+        Handle &operator=(const Handle &) = delete;
+        Handle &operator=(Handle &&) = delete;
+
+        ~Handle() {
+            if (!_data) return;
+            if constexpr (SharedHold) _lock->unlock_shared();
+            else _lock->unlock();
+        }
+
+        U *operator->() const { return _data; }
+        U &operator*() const { return *_data; }
+
+    private:
+        U *_data;
+        LockPolicy *_lock;
+    };
+
+public:
+    using LockedPtr = Handle<T, false>;
+    using ConstLockedPtr = Handle<const T, kShared>;
+
+    template <typename... Args>
+    explicit Guarded(Args &&... args) : _data(std::forward<Args>(args)...) {}
+
+    Guarded(const Guarded &) = delete;
+    Guarded &operator=(const Guarded &) = delete;
+
+    /**
+     * @brief Locks exclusively and returns a handle that unlocks when destroyed.
+     */
+    LockedPtr write() {
+        _lock.lock();
+        return LockedPtr(_data, _lock);
+    }
+
+    /**
+     * @brief Locks for reading (shared when the policy supports it) and returns a const handle.
+     */
+    ConstLockedPtr read() {
+        if constexpr (kShared) _lock.lock_shared();
+        else _lock.lock();
+        return ConstLockedPtr(_data, _lock);
+    }
+
+    /**
+     * @brief Runs fn(T &) with the lock held exclusively and returns its result.
+     * The result is returned by value; a reference would outlive the lock.
+     */
+    template <typename F>
+    std::invoke_result_t<F, T &> with_lock(F &&fn) {
+        static_assert(!std::is_reference<std::invoke_result_t<F, T &> >::value,
+                      "critical sections must return by value");
+        LockedPtr held = write();
+        return std::forward<F>(fn)(*held);
+    }
+
+    /**
+     * @brief Runs fn(const T &) with the lock held for reading and returns its result by value.
+     */
+    template <typename F>
+    std::invoke_result_t<F, const T &> with_read_lock(F &&fn) {
+        static_assert(!std::is_reference<std::invoke_result_t<F, const T &> >::value,
+                      "critical sections must return by value");
+        ConstLockedPtr held = read();
+        return std::forward<F>(fn)(*held);
+    }
+
+private:
+    LockPolicy _lock;
+    alignas(kDataAlign) T _data;
+};
+
+/**
+ * @brief Reader/writer Guarded: readers share the lock, so the data gets its own line.
+ */
+template <typename T, typename Layout = LayoutSeparateLines>
+using Synchronized = Guarded<T, std::shared_mutex, Layout>;
+
+#endif // GUARDED_HPP
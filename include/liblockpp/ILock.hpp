@@ -2,6 +2,7 @@
 #define LIBLOCKPP_H
 
 #include "lock_types.h"
+#include <cstdint>
 #include <memory>
 
 /**
@@ -49,4 +50,11 @@ public:
  */
 std::unique_ptr<ILock> createLock(lock_type_t type);
 
+/**
+ * @brief Number of times another thread revoked the owner's bias on a biased lock.
+ * @param lock A lock created with LOCK_TYPE_BIASED_TICKET or LOCK_TYPE_BIASED_MCS.
+ * @return The revocation count, or 0 for any other lock type.
+ */
+std::uint64_t biasRevocations(const ILock &lock);
+
 #endif // LIBLOCKPP_H
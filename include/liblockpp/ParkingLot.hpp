@@ -0,0 +1,77 @@
+#ifndef PARKING_LOT_HPP
+#define PARKING_LOT_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief A global parking lot keyed by address, in the style of WebKit's WTF::ParkingLot.
+ *
+ * Any address can be parked on. The wait queues live in a fixed, hashed table
+ * of buckets, so the parked-on object needs no storage of its own beyond a bit
+ * that remembers someone may be waiting. Validation and unpark callbacks run
+ * under the bucket lock, which lets a lock built on top update its state word
+ * atomically with respect to threads that are about to park.
+ */
+class ParkingLot {
+public:
+    struct UnparkResult {
+        bool didUnparkThread = false;
+        bool mayHaveMoreThreads = false; // Another thread is still parked on the same address
+        bool timeToBeFair = false;       // Set roughly once per kFairIntervalNs per bucket
+    };
+
+    static constexpr int kBuckets = 1024;
+    static constexpr std::uint64_t kFairIntervalNs = 1000000;
+
+    ParkingLot() = delete;
+
+    /**
+     * @brief Parks the calling thread on addr if validate() still holds.
+     * @param validate bool() run under the bucket lock; returning false aborts the park.
+     * @param token Receives the value returned by the unparker's callback; may be nullptr.
+     * @return true once the thread has been unparked, false if validation failed.
+     */
+    template <typename Validate>
+    static bool park(const void *addr, Validate &&validate, std::intptr_t *token = nullptr) {
+        return parkImpl(addr, &invokeValidate<Validate>, &validate, token);
+    }
+
+    /**
+     * @brief Wakes the longest-parked thread on addr, if any.
+     * @param callback std::intptr_t(UnparkResult) run under the bucket lock whether or not a
+     * thread was found; its return value becomes the woken thread's park token.
+     */
+    template <typename Callback>
+    static UnparkResult unparkOne(const void *addr, Callback &&callback) {
+        return unparkOneImpl(addr, &invokeCallback<Callback>, &callback);
+    }
+
+    static UnparkResult unparkOne(const void *addr) {
+        return unparkOneImpl(addr, nullptr, nullptr);
+    }
+
+    /**
+     * @brief Wakes every thread parked on addr and returns how many there were.
+     */
+    static unsigned unparkAll(const void *addr);
+
+private:
+    using ValidateFn = bool (*)(void *);
+    using CallbackFn = std::intptr_t (*)(UnparkResult, void *);
+
+    template <typename Validate>
+    static bool invokeValidate(void *validate) {
+        return (*static_cast<std::remove_reference_t<Validate> *>(validate))();
+    }
+
+    template <typename Callback>
+    static std::intptr_t invokeCallback(UnparkResult result, void *callback) {
+        return (*static_cast<std::remove_reference_t<Callback> *>(callback))(result);
+    }
+
+    static bool parkImpl(const void *addr, ValidateFn validate, void *ctx, std::intptr_t *token);
+    static UnparkResult unparkOneImpl(const void *addr, CallbackFn callback, void *ctx);
+};
+
+#endif // PARKING_LOT_HPP
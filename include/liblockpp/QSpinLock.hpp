@@ -0,0 +1,63 @@
+#ifndef QSPINLOCK_HPP
+#define QSPINLOCK_HPP
+
+#include <cstdint>
+
+/**
+ * @brief A four-byte queued spinlock in the style of the Linux kernel qspinlock.
+ *
+ * The whole lock is one 32-bit word (locked byte, pending bit and an encoded
+ * queue tail), so it can be embedded in small objects instead of paying for a
+ * heap-allocated ILock. The uncontended path is a single CAS; under contention
+ * waiters queue MCS-style on per-thread nodes from a table allocated on first
+ * contention, and yield after a short spin.
+ *
+ * Satisfies the standard Lockable requirements, so it works with
+ * std::lock_guard and std::unique_lock.
+ */
+class QSpinLock {
+public:
+    QSpinLock() = default;
+
+    QSpinLock(const QSpinLock &) = delete;
+    QSpinLock &operator=(const QSpinLock &) = delete;
+
+    void lock() {
+        std::uint32_t expected = 0;
+        if (__builtin_expect(__atomic_compare_exchange_n(&_val, &expected, kLockedVal, false,
+                                                         __ATOMIC_ACQUIRE, __ATOMIC_RELAXED), 1)) {
+            return;
+        }
+        lockSlow(expected);
+    }
+
+    void unlock() {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        // Only the holder writes the locked byte, so a plain release store suffices.
+        __atomic_store_n(reinterpret_cast<std::uint8_t *>(&_val), 0, __ATOMIC_RELEASE);
+#else
+        __atomic_fetch_sub(&_val, kLockedVal, __ATOMIC_RELEASE);
+#endif
+    }
+
+    bool trylock() {
+        std::uint32_t expected = __atomic_load_n(&_val, __ATOMIC_RELAXED);
+        if (expected != 0) return false;
+        return __atomic_compare_exchange_n(&_val, &expected, kLockedVal, false,
+                                           __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    }
+
+    bool try_lock() { return trylock(); }
+
+private:
+    static constexpr std::uint32_t kLockedVal = 1u;
+
+    void lockSlow(std::uint32_t val);
+
+    // Accessed only through __atomic builtins so the locked byte can be released on its own.
+    std::uint32_t _val = 0;
+};
+
+static_assert(sizeof(QSpinLock) == 4, "QSpinLock must stay a single 32-bit word");
+
+#endif // QSPINLOCK_HPP
@@ -0,0 +1,88 @@
+#ifndef REMOTE_CORE_HPP
+#define REMOTE_CORE_HPP
+
+#include <exception>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Remote core locking: a dedicated server thread runs every critical section.
+ *
+ * Instead of taking a lock, a client posts the critical section into its own
+ * cache-line-padded mailbox on the server and waits for it to complete. The
+ * server, optionally pinned to one CPU, polls the mailboxes and runs the
+ * requests one at a time, so the protected data stays in that core's caches.
+ *
+ * When the server finds nothing to do for kIdleScans passes it either keeps
+ * polling (yielding the CPU between passes) or parks on a futex until a client
+ * posts, depending on the idle policy.
+ */
+class RemoteCoreServer {
+public:
+    enum class Idle {
+        Poll, // Keep scanning; lowest latency, but the server's CPU is never released
+        Park  // Sleep until the next request; clients pay a wakeup after idle periods
+    };
+
+    static constexpr int kMaxClients = 256; // Threads that can have a request posted at once
+    static constexpr int kIdleScans = 256;
+
+    /**
+     * @brief Starts the server thread.
+     * @param cpu CPU to pin the server to, or -1 to leave it unpinned.
+     * @throws std::runtime_error if the server cannot be pinned to cpu.
+     */
+    explicit RemoteCoreServer(int cpu = -1, Idle idle = Idle::Poll);
+
+    /**
+     * @brief Stops and joins the server thread. No client may be inside execute().
+     */
+    ~RemoteCoreServer();
+
+    RemoteCoreServer(const RemoteCoreServer &) = delete;
+    RemoteCoreServer &operator=(const RemoteCoreServer &) = delete;
+
+    /**
+     * @brief Runs fn() on the server thread and returns its result.
+     * Exceptions thrown by fn are rethrown to the caller. Calls made from inside a
+     * critical section of the same server run inline.
+     */
+    template <typename F>
+    std::invoke_result_t<F &> execute(F &&fn) {
+        using R = std::invoke_result_t<F &>;
+        static_assert(!std::is_reference<R>::value, "critical sections must return by value");
+        std::exception_ptr error;
+        if constexpr (std::is_void<R>::value) {
+            auto call = [&fn, &error] {
+                try { fn(); } catch (...) { error = std::current_exception(); }
+            };
+            post(&invoke<decltype(call)>, &call);
+            if (error) std::rethrow_exception(error);
+        } else {
+            std::optional<R> result;
+            auto call = [&fn, &error, &result] {
+                try { result.emplace(fn()); } catch (...) { error = std::current_exception(); }
+            };
+            post(&invoke<decltype(call)>, &call);
+            if (error) std::rethrow_exception(error);
+            return std::move(*result);
+        }
+    }
+
+private:
+    using Thunk = void (*)(void *);
+
+    template <typename Call>
+    static void invoke(void *call) {
+        (*static_cast<Call *>(call))();
+    }
+
+    void post(Thunk thunk, void *call);
+
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+};
+
+#endif // REMOTE_CORE_HPP
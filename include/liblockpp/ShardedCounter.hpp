@@ -0,0 +1,68 @@
+#ifndef SHARDED_COUNTER_HPP
+#define SHARDED_COUNTER_HPP
+
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief A sharded counter for statistics, reference counts and quotas that would
+ * otherwise be a shared integer behind a lock.
+ *
+ * Every CPU gets its own cache-line-padded slot, so add() is one uncontended
+ * atomic add. readExact() includes every add that completed before it was called.
+ *
+ * With a non-zero batch, a slot whose value reaches +/-batch is folded into the
+ * central count, and read() returns just that count: one load, off by less than
+ * batch per slot. compare() answers quota checks from it unless the counter is
+ * within that error of the limit. With a zero batch nothing is folded and read()
+ * sums the slots without locking, which may miss adds that race with it.
+ */
+class ShardedCounter {
+public:
+    static constexpr unsigned int kMaxShards = 256;
+    static constexpr unsigned int kCpuRefresh = 256; // Adds between re-reading the calling thread's CPU
+
+    /**
+     * @param batch Slot magnitude at which the slot is folded into the central count; 0 never folds.
+     */
+    explicit ShardedCounter(std::int64_t batch = 0);
+    ~ShardedCounter();
+
+    ShardedCounter(const ShardedCounter &) = delete;
+    ShardedCounter &operator=(const ShardedCounter &) = delete;
+
+    void add(std::int64_t delta);
+
+    ShardedCounter &operator+=(std::int64_t delta) {
+        add(delta);
+        return *this;
+    }
+
+    ShardedCounter &operator++() {
+        add(1);
+        return *this;
+    }
+
+    /**
+     * @brief Approximate value: the central count, off by less than batch * slots.
+     * With a zero batch, a lock-free sum of the slots that may miss racing adds.
+     */
+    std::int64_t read() const;
+
+    /**
+     * @brief Sum that includes every add completed before the call. Serializes with folds.
+     */
+    std::int64_t readExact() const;
+
+    /**
+     * @brief Compares the counter with rhs, returning -1, 0 or 1.
+     * Uses the central count when its error bound keeps the answer certain, otherwise readExact().
+     */
+    int compare(std::int64_t rhs) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+};
+
+#endif // SHARDED_COUNTER_HPP
@@ -1,13 +1,8 @@
 #ifndef LOCK_H
 #define LOCK_H
 
-// This enum is shared between C and C++.
-typedef enum {
-    LOCK_TYPE_PTHREAD_MUTEX,
-    LOCK_TYPE_TICKET,
-    LOCK_TYPE_MCS,
-    LOCK_TYPE_CLH
-} lock_type_t;
+// The lock_type_t enum is shared between C and C++.
+#include "lock_types.h"
 
 
 #ifdef __cplusplus
@@ -36,6 +31,9 @@ void destroy_lock_object(lock_t *lock_obj);
 
 void release_all_locks_held_by_thread(void);
 
+// Number of times another thread revoked the owner's bias on a LOCK_TYPE_BIASED_* lock; 0 for other types.
+unsigned long long lock_bias_revocations(lock_t *lock_obj);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,7 +6,17 @@ typedef enum {
     LOCK_TYPE_PTHREAD_MUTEX,
     LOCK_TYPE_TICKET,
     LOCK_TYPE_MCS,
-    LOCK_TYPE_CLH
+    LOCK_TYPE_CLH,
+    LOCK_TYPE_MCS_TP, // Time-published MCS: skips preempted waiters, blocks if the holder is preempted
+    LOCK_TYPE_QSPINLOCK, // Four-byte queued spinlock with per-thread MCS nodes (see qspinlock.h)
+    // Reentrant variants: the holding thread may re-acquire, and must unlock once per acquire.
+    LOCK_TYPE_RECURSIVE_TICKET,
+    LOCK_TYPE_RECURSIVE_MCS,
+    LOCK_TYPE_RECURSIVE_CLH,
+    // Biased variants: the thread that uses the lock most acquires it with plain loads and
+    // stores; other threads revoke the bias and fall back to the ticket or MCS algorithm.
+    LOCK_TYPE_BIASED_TICKET,
+    LOCK_TYPE_BIASED_MCS
 } lock_type_t;
 
 #endif // LOCK_TYPES_H
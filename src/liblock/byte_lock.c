@@ -0,0 +1,67 @@
+#define _GNU_SOURCE
+#include "byte_lock.h"
+#include "parking_lot.h"
+#include <sched.h>
+
+#define BYTE_LOCK_HANDOFF 1 // Park token: the lock was passed to the woken thread and is already held
+
+// Runs under the bucket lock: park only if the lock is still held with the parked bit set.
+static bool byte_lock_should_park(void *ctx) {
+    byte_lock_t *lock = ctx;
+    return __atomic_load_n(&lock->state, __ATOMIC_RELAXED) == (BYTE_LOCK_HELD | BYTE_LOCK_PARKED);
+}
+
+void byte_lock_lock_slow(byte_lock_t *lock) {
+    int spins = 0;
+    for (;;) {
+        uint8_t state = __atomic_load_n(&lock->state, __ATOMIC_RELAXED);
+        if (!(state & BYTE_LOCK_HELD)) {
+            if (__atomic_compare_exchange_n(&lock->state, &state, (uint8_t) (state | BYTE_LOCK_HELD), true,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return;
+            }
+            continue;
+        }
+        // Spin only while nobody is parked; after that, spinning just delays the holder.
+        if (!(state & BYTE_LOCK_PARKED) && spins < BYTE_LOCK_SPINS) {
+            ++spins;
+            sched_yield();
+            continue;
+        }
+        if (!(state & BYTE_LOCK_PARKED) &&
+            !__atomic_compare_exchange_n(&lock->state, &state, (uint8_t) (state | BYTE_LOCK_PARKED), false,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            continue;
+        }
+        intptr_t token = 0;
+        if (parking_lot_park(lock, byte_lock_should_park, lock, &token) && token == BYTE_LOCK_HANDOFF) {
+            return; // Handed off: the unlocker left the held bit set for us
+        }
+    }
+}
+
+// Runs under the bucket lock, so no thread can park on the lock between this store and the wake.
+static intptr_t byte_lock_unparked(parking_unpark_result_t result, void *ctx) {
+    byte_lock_t *lock = ctx;
+    uint8_t parked = result.may_have_more_threads ? BYTE_LOCK_PARKED : 0;
+    if (result.did_unpark_thread && result.time_to_be_fair) {
+        __atomic_store_n(&lock->state, (uint8_t) (BYTE_LOCK_HELD | parked), __ATOMIC_RELAXED);
+        return BYTE_LOCK_HANDOFF;
+    }
+    __atomic_store_n(&lock->state, parked, __ATOMIC_RELEASE);
+    return 0;
+}
+
+void byte_lock_unlock_slow(byte_lock_t *lock) {
+    for (;;) {
+        uint8_t state = __atomic_load_n(&lock->state, __ATOMIC_RELAXED);
+        if (state == BYTE_LOCK_HELD) {
+            if (__atomic_compare_exchange_n(&lock->state, &state, 0, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+                return;
+            }
+            continue;
+        }
+        parking_lot_unpark_one(lock, byte_lock_unparked, lock);
+        return;
+    }
+}
@@ -0,0 +1,235 @@
+#define _GNU_SOURCE
+#include "epoch.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#ifdef __linux__
+#include <linux/membarrier.h>
+#endif
+
+#define CACHE_LINE 64
+
+// An object is retired in the epoch current at epoch_retire(). Readers that might see it
+// entered no later than that epoch, and the global epoch only moves past e + 1 once all of
+// them have exited, so the object is freed when the global epoch reaches e + 2.
+#define EPOCH_GRACE 2
+
+typedef struct epoch_retired_s {
+    void *ptr;
+    epoch_free_fn free_fn;
+    uint64_t epoch;
+    struct epoch_retired_s *next;
+} epoch_retired_t;
+
+typedef struct __attribute__((aligned(CACHE_LINE))) epoch_record_s {
+    // The epoch this thread observed, shifted left by one, with bit 0 set while it is inside
+    // a read-side section. 0 when quiescent.
+    _Atomic uint64_t state;
+    _Atomic bool in_use;
+    struct epoch_record_s *next; // Registry link; records are recycled, never freed
+} epoch_record_t;
+
+static struct __attribute__((aligned(CACHE_LINE))) {
+    _Atomic uint64_t epoch;
+} epoch_clock = { 1 };
+
+static _Atomic(epoch_record_t *) epoch_registry = NULL;
+
+// Set once when expedited membarrier is available: the reclaimer then issues the full
+// fence on the readers' behalf and epoch_enter() only needs a compiler barrier.
+static bool epoch_light_fence = false;
+static pthread_once_t epoch_once = PTHREAD_ONCE_INIT;
+static pthread_key_t epoch_exit_key;
+
+// Retired objects left behind by exited threads, freed by whichever thread reclaims next.
+static pthread_mutex_t epoch_orphans_mutex = PTHREAD_MUTEX_INITIALIZER;
+static epoch_retired_t *epoch_orphans_head = NULL;
+static epoch_retired_t *epoch_orphans_tail = NULL;
+
+// --- Thread-Local Storage for C ---
+static _Thread_local epoch_record_t *epoch_self_c = NULL;
+static _Thread_local unsigned int epoch_nesting_c = 0;
+static _Thread_local epoch_retired_t *epoch_limbo_head_c = NULL; // Oldest first
+static _Thread_local epoch_retired_t *epoch_limbo_tail_c = NULL;
+static _Thread_local unsigned int epoch_retired_since_reclaim_c = 0;
+
+static void epoch_thread_exit(void *value);
+
+static void epoch_init(void) {
+    pthread_key_create(&epoch_exit_key, epoch_thread_exit);
+#ifdef __NR_membarrier
+    epoch_light_fence = syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+#endif
+}
+
+static void epoch_heavy_fence(void) {
+#ifdef __NR_membarrier
+    if (epoch_light_fence && syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0) == 0) return;
+#endif
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+static epoch_record_t *epoch_register_slow(void) {
+    pthread_once(&epoch_once, epoch_init);
+
+    epoch_record_t *rec = atomic_load_explicit(&epoch_registry, memory_order_acquire);
+    for (; rec; rec = rec->next) {
+        bool expected = false;
+        if (!atomic_load_explicit(&rec->in_use, memory_order_relaxed) &&
+            atomic_compare_exchange_strong_explicit(&rec->in_use, &expected, true, memory_order_acquire,
+                                                    memory_order_relaxed)) {
+            break;
+        }
+    }
+    if (!rec) {
+        rec = aligned_alloc(CACHE_LINE, sizeof(epoch_record_t));
+        if (!rec) exit(1);
+        atomic_init(&rec->state, 0);
+        atomic_init(&rec->in_use, true);
+        rec->next = atomic_load_explicit(&epoch_registry, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&epoch_registry, &rec->next, rec, memory_order_release,
+                                                      memory_order_relaxed)) {
+        }
+    }
+    epoch_self_c = rec;
+    pthread_setspecific(epoch_exit_key, rec);
+    return rec;
+}
+
+void epoch_register_thread(void) {
+    if (!epoch_self_c) epoch_register_slow();
+}
+
+// --- Read-Side Sections ---
+void epoch_enter(void) {
+    epoch_record_t *rec = epoch_self_c;
+    if (__builtin_expect(!rec, 0)) rec = epoch_register_slow();
+    if (epoch_nesting_c++ > 0) return;
+
+    // Acquire: if we observe an advance, we also observe every unlink that preceded it.
+    uint64_t e = atomic_load_explicit(&epoch_clock.epoch, memory_order_acquire);
+    atomic_store_explicit(&rec->state, (e << 1) | 1, memory_order_relaxed);
+    // The state store must be visible before any shared pointer is loaded.
+    if (epoch_light_fence) atomic_signal_fence(memory_order_seq_cst);
+    else atomic_thread_fence(memory_order_seq_cst);
+}
+
+void epoch_exit(void) {
+    if (--epoch_nesting_c > 0) return;
+    atomic_store_explicit(&epoch_self_c->state, 0, memory_order_release);
+}
+
+// --- Reclamation ---
+// Moves the epoch forward if every thread inside a read-side section has observed the
+// current one. Returns the epoch in force afterwards.
+static uint64_t epoch_try_advance(void) {
+    // A thread that never registered must still agree with the readers on the fence protocol.
+    pthread_once(&epoch_once, epoch_init);
+    uint64_t e = atomic_load_explicit(&epoch_clock.epoch, memory_order_acquire);
+    epoch_heavy_fence();
+    for (epoch_record_t *rec = atomic_load_explicit(&epoch_registry, memory_order_acquire); rec; rec = rec->next) {
+        uint64_t state = atomic_load_explicit(&rec->state, memory_order_acquire);
+        if ((state & 1) && (state >> 1) != e) return e;
+    }
+    if (atomic_compare_exchange_strong_explicit(&epoch_clock.epoch, &e, e + 1, memory_order_acq_rel,
+                                                memory_order_acquire)) {
+        return e + 1;
+    }
+    return e;
+}
+
+// Unlinks the prefix of a list that is safe to free in epoch e.
+static epoch_retired_t *epoch_detach_ready(epoch_retired_t **head, epoch_retired_t **tail, uint64_t e) {
+    epoch_retired_t *ready = *head, *last = NULL;
+    for (epoch_retired_t *n = *head; n && n->epoch + EPOCH_GRACE <= e; n = n->next) last = n;
+    if (!last) return NULL;
+    *head = last->next;
+    if (!*head) *tail = NULL;
+    last->next = NULL;
+    return ready;
+}
+
+static void epoch_free_list(epoch_retired_t *n) {
+    while (n) {
+        epoch_retired_t *next = n->next;
+        n->free_fn(n->ptr);
+        free(n);
+        n = next;
+    }
+}
+
+static void epoch_append(epoch_retired_t **head, epoch_retired_t **tail, epoch_retired_t *first,
+                         epoch_retired_t *last) {
+    if (*tail) (*tail)->next = first;
+    else *head = first;
+    *tail = last;
+}
+
+void epoch_reclaim(void) {
+    uint64_t e = epoch_try_advance();
+    epoch_free_list(epoch_detach_ready(&epoch_limbo_head_c, &epoch_limbo_tail_c, e));
+
+    if (pthread_mutex_trylock(&epoch_orphans_mutex) == 0) {
+        epoch_retired_t *ready = epoch_detach_ready(&epoch_orphans_head, &epoch_orphans_tail, e);
+        pthread_mutex_unlock(&epoch_orphans_mutex);
+        epoch_free_list(ready);
+    }
+}
+
+void epoch_retire(void *ptr, epoch_free_fn free_fn) {
+    // Registering arms the exit hook that hands our leftovers to other threads.
+    if (!epoch_self_c) epoch_register_slow();
+
+    epoch_retired_t *n = malloc(sizeof(epoch_retired_t));
+    if (!n) exit(1);
+    n->ptr = ptr;
+    n->free_fn = free_fn;
+    // The caller's unlink must be visible before we read the epoch the object is tagged with.
+    atomic_thread_fence(memory_order_seq_cst);
+    n->epoch = atomic_load_explicit(&epoch_clock.epoch, memory_order_relaxed);
+    n->next = NULL;
+    epoch_append(&epoch_limbo_head_c, &epoch_limbo_tail_c, n, n);
+
+    if (++epoch_retired_since_reclaim_c >= EPOCH_RECLAIM_EVERY) {
+        epoch_retired_since_reclaim_c = 0;
+        epoch_reclaim();
+    }
+}
+
+void epoch_barrier(void) {
+    while (epoch_limbo_head_c) {
+        epoch_reclaim();
+        if (epoch_limbo_head_c) sched_yield();
+    }
+}
+
+// --- Thread Exit ---
+static void epoch_release_record(epoch_record_t *rec) {
+    if (epoch_limbo_head_c) {
+        pthread_mutex_lock(&epoch_orphans_mutex);
+        epoch_append(&epoch_orphans_head, &epoch_orphans_tail, epoch_limbo_head_c, epoch_limbo_tail_c);
+        pthread_mutex_unlock(&epoch_orphans_mutex);
+        epoch_limbo_head_c = epoch_limbo_tail_c = NULL;
+    }
+    atomic_store_explicit(&rec->state, 0, memory_order_release);
+    atomic_store_explicit(&rec->in_use, false, memory_order_release);
+    epoch_self_c = NULL;
+    epoch_nesting_c = 0;
+    epoch_retired_since_reclaim_c = 0;
+}
+
+static void epoch_thread_exit(void *value) {
+    epoch_release_record((epoch_record_t *) value);
+}
+
+void epoch_unregister_thread(void) {
+    epoch_record_t *rec = epoch_self_c;
+    if (!rec) return;
+    pthread_setspecific(epoch_exit_key, NULL);
+    epoch_release_record(rec);
+}
@@ -1,16 +1,35 @@
 #define _GNU_SOURCE
 #include "lock.h"
+#include "qspinlock.h"
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdatomic.h>
 #include <pthread.h>
 #include <string.h>
 #include <sched.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
 #if defined(__x86_64__) || defined(__i386__)
 #include <immintrin.h> // For _mm_pause
 #endif
 
 #define CACHE_LINE 64
+#define MCS_MAX_NESTING 16 // MCS locks a thread can hold at once before nodes spill to the heap
+
+// Time-published MCS tuning. A waiter whose heartbeat is older than TP_WAITER_PATIENCE_NS
+// is presumed preempted and skipped by the releaser; a critical section older than
+// TP_HOLDER_PATIENCE_NS suggests the holder was preempted, so waiters block instead of spinning.
+#define TP_WAITER_PATIENCE_NS 50000ull
+#define TP_HOLDER_PATIENCE_NS 200000ull
+
+// Consecutive acquisitions by one thread through the fallback lock after which a revoked
+// biased lock is biased towards that thread again.
+#define BIAS_REBIAS_AFTER 1024
 
 #if defined(__x86_64__) || defined(__i386__)
 #define CPU_RELAX() _mm_pause()
@@ -26,23 +45,74 @@ typedef struct __attribute__((aligned(CACHE_LINE))) {
     _Atomic unsigned int next_ticket;
 } ticket_lock_impl_t;
 
+// States of a time-published waiter; tp_state doubles as its futex word.
+enum {
+    TP_WAITING,
+    TP_PARKED,  // Blocked in the kernel, must be woken after a grant or skip
+    TP_GRANTED,
+    TP_SKIPPED  // Unlinked by the releaser while it looked preempted; must requeue
+};
+
 typedef struct __attribute__((aligned(CACHE_LINE))) mcs_qnode_s {
-    struct mcs_qnode_s *next;
+    _Atomic(struct mcs_qnode_s *) next;
     _Atomic(bool) locked;
+    // Used only by LOCK_TYPE_MCS_TP.
+    _Atomic unsigned int tp_state;
+    _Atomic uint64_t tp_heartbeat;
 } mcs_qnode_t;
 
+typedef struct {
+    _Atomic(mcs_qnode_t *) tail;
+    mcs_qnode_t *holder; // Node enqueued by the current holder, only touched by it
+    _Atomic uint64_t cs_start; // When the current holder acquired the lock (MCS_TP only)
+} mcs_lock_impl_t;
+
 typedef struct __attribute__((aligned(CACHE_LINE))) clh_qnode_s {
     _Atomic(bool) locked;
+    struct clh_qnode_s *next_free; // Links nodes in the owning thread's free list
 } clh_qnode_t;
 
+// The CLH tail word packs the tail node's address (low CLH_PTR_BITS bits, enough for user
+// space on x86-64 and AArch64) with a count of enqueues in the high bits. Nodes recycle
+// between threads, so the count is what lets trylock notice that the released tail it
+// checked was adopted and enqueued again before its CAS (ABA).
+#define CLH_PTR_BITS 48
+#define CLH_PTR_MASK ((1ull << CLH_PTR_BITS) - 1)
+
+typedef struct {
+    _Atomic uint64_t tail;
+    clh_qnode_t *holder; // Node enqueued by the current holder, only touched by it
+} clh_lock_impl_t;
+
+// Bias word of a LOCK_TYPE_BIASED_* lock: BIAS_UNBIASED until first locked, then either
+// biased towards a thread (its owner tag in the upper bits) or BIAS_REVOKED.
+#define BIAS_UNBIASED 0ull
+#define BIAS_REVOKED 2ull
+#define BIAS_TOWARDS(tag) (((uint64_t) (tag) << 2) | 1ull)
+
+typedef struct {
+    _Atomic uint64_t state;
+    _Atomic uint32_t in_cs; // Set by the bias owner while it holds the lock through the fast path
+    bool fast_held; // The current holder took the fast path, only touched by it
+    uint32_t streak_owner; // Protected by the fallback lock
+    uint32_t streak;
+    _Atomic uint64_t revocations;
+} bias_state_t;
+
 typedef struct  {
     lock_type_t type;
+    // Used only by the LOCK_TYPE_RECURSIVE_* and LOCK_TYPE_BIASED_* types.
+    _Atomic uint32_t owner; // Tag of the holding thread, 0 when free
+    uint32_t depth; // Acquisitions by the holder not yet released, only touched by it
+    // Used only by the LOCK_TYPE_BIASED_* types.
+    bias_state_t bias;
 
     union {
         pthread_mutex_t p_mutex;
         ticket_lock_impl_t ticket_lock;
-        _Atomic(mcs_qnode_t *) mcs_lock;
-        _Atomic(clh_qnode_t *) clh_lock_tail;
+        mcs_lock_impl_t mcs_lock;
+        clh_lock_impl_t clh_lock;
+        qspinlock_t qspin;
     } impl;
 } lock_impl_t;
 
@@ -55,12 +125,24 @@ typedef struct held_lock_node_s {
 } held_lock_node_t;
 
 static _Thread_local held_lock_node_t *thread_held_locks_head_c = NULL;
-static _Thread_local mcs_qnode_t thread_mcs_qnode_c;
-// --- FIX: Allocation-free CLH node management ---
-static _Thread_local clh_qnode_t clh_node_A_c;
-static _Thread_local clh_qnode_t clh_node_B_c;
-static _Thread_local clh_qnode_t *my_clh_node_c = NULL;
-static _Thread_local clh_qnode_t *next_clh_node_c = NULL;
+// Compact, never reused tag identifying this thread as a lock owner; 0 until first needed.
+static _Thread_local uint32_t thread_owner_tag_c = 0;
+static _Atomic uint32_t next_owner_tag_c = 1;
+// One MCS node per lock a thread may hold concurrently; bit i of the mask marks node i busy.
+static _Thread_local mcs_qnode_t thread_mcs_qnodes_c[MCS_MAX_NESTING];
+static _Thread_local unsigned int thread_mcs_qnodes_busy_c = 0;
+// CLH nodes migrate between threads: a releasing thread adopts its predecessor's
+// node. Each thread keeps the nodes it currently owns in a free list.
+static _Thread_local clh_qnode_t *clh_free_nodes_c = NULL;
+static _Thread_local bool clh_exit_hook_armed_c = false;
+// Nodes of exited threads, kept for reuse rather than freed: a trylock may still read a
+// node it saw at the tail some time ago.
+// Guarded by a spin flag, not a pthread mutex: inside liblock_preload.so pthread_mutex_lock
+// is the interposed one, which would re-enter the CLH lock that is asking for a node.
+static clh_qnode_t *clh_orphan_nodes_c = NULL;
+static atomic_flag clh_orphan_busy_c = ATOMIC_FLAG_INIT;
+static pthread_key_t clh_exit_key_c;
+static pthread_once_t clh_exit_once_c = PTHREAD_ONCE_INIT;
 
 
 // --- Function Prototypes for C ---
@@ -68,18 +150,70 @@ static void _mutex_lock(lock_t *self, const char *file, int line);
 
 static void _mutex_unlock(lock_t *self);
 
+static bool _mutex_trylock(lock_t *self, const char *file, int line);
+
 static void _ticket_lock(lock_t *self, const char *file, int line);
 
 static void _ticket_unlock(lock_t *self);
 
+static bool _ticket_trylock(lock_t *self, const char *file, int line);
+
 static void _mcs_lock(lock_t *self, const char *file, int line);
 
 static void _mcs_unlock(lock_t *self);
 
+static bool _mcs_trylock(lock_t *self, const char *file, int line);
+
 static void _clh_lock(lock_t *self, const char *file, int line);
 
 static void _clh_unlock(lock_t *self);
 
+static bool _clh_trylock(lock_t *self, const char *file, int line);
+
+static void _mcs_tp_lock(lock_t *self, const char *file, int line);
+
+static void _mcs_tp_unlock(lock_t *self);
+
+static bool _mcs_tp_trylock(lock_t *self, const char *file, int line);
+
+static void _qspin_lock(lock_t *self, const char *file, int line);
+
+static void _qspin_unlock(lock_t *self);
+
+static bool _qspin_trylock(lock_t *self, const char *file, int line);
+
+static void _rticket_lock(lock_t *self, const char *file, int line);
+
+static void _rticket_unlock(lock_t *self);
+
+static bool _rticket_trylock(lock_t *self, const char *file, int line);
+
+static void _rmcs_lock(lock_t *self, const char *file, int line);
+
+static void _rmcs_unlock(lock_t *self);
+
+static bool _rmcs_trylock(lock_t *self, const char *file, int line);
+
+static void _rclh_lock(lock_t *self, const char *file, int line);
+
+static void _rclh_unlock(lock_t *self);
+
+static bool _rclh_trylock(lock_t *self, const char *file, int line);
+
+static void _bticket_lock(lock_t *self, const char *file, int line);
+
+static void _bticket_unlock(lock_t *self);
+
+static bool _bticket_trylock(lock_t *self, const char *file, int line);
+
+static void _bmcs_lock(lock_t *self, const char *file, int line);
+
+static void _bmcs_unlock(lock_t *self);
+
+static bool _bmcs_trylock(lock_t *self, const char *file, int line);
+
+static void bias_init(lock_impl_t *p);
+
 
 // --- List Management for C ---
 static void add_to_held_list_c(lock_t *lock, const char *file, int line) {
@@ -120,35 +254,98 @@ lock_t *create_lock_object(lock_type_t type) {
     memset(obj, 0, sizeof(lock_t));
     obj->pimpl = pimpl;
     pimpl->type = type;
+    atomic_init(&pimpl->owner, 0);
+    pimpl->depth = 0;
 
     switch (type) {
         case LOCK_TYPE_PTHREAD_MUTEX:
             pthread_mutex_init(&pimpl->impl.p_mutex, NULL);
             obj->_lock = _mutex_lock;
             obj->unlock = _mutex_unlock;
+            obj->_trylock = _mutex_trylock;
             break;
         case LOCK_TYPE_TICKET:
             atomic_init(&pimpl->impl.ticket_lock.now_serving, 0);
             atomic_init(&pimpl->impl.ticket_lock.next_ticket, 0);
             obj->_lock = _ticket_lock;
             obj->unlock = _ticket_unlock;
+            obj->_trylock = _ticket_trylock;
+            break;
+        case LOCK_TYPE_RECURSIVE_TICKET:
+            atomic_init(&pimpl->impl.ticket_lock.now_serving, 0);
+            atomic_init(&pimpl->impl.ticket_lock.next_ticket, 0);
+            obj->_lock = _rticket_lock;
+            obj->unlock = _rticket_unlock;
+            obj->_trylock = _rticket_trylock;
+            break;
+        case LOCK_TYPE_BIASED_TICKET:
+            atomic_init(&pimpl->impl.ticket_lock.now_serving, 0);
+            atomic_init(&pimpl->impl.ticket_lock.next_ticket, 0);
+            bias_init(pimpl);
+            obj->_lock = _bticket_lock;
+            obj->unlock = _bticket_unlock;
+            obj->_trylock = _bticket_trylock;
             break;
         case LOCK_TYPE_MCS:
-            atomic_init(&pimpl->impl.mcs_lock, NULL);
+            atomic_init(&pimpl->impl.mcs_lock.tail, NULL);
+            pimpl->impl.mcs_lock.holder = NULL;
             obj->_lock = _mcs_lock;
             obj->unlock = _mcs_unlock;
+            obj->_trylock = _mcs_trylock;
+            break;
+        case LOCK_TYPE_RECURSIVE_MCS:
+            atomic_init(&pimpl->impl.mcs_lock.tail, NULL);
+            pimpl->impl.mcs_lock.holder = NULL;
+            obj->_lock = _rmcs_lock;
+            obj->unlock = _rmcs_unlock;
+            obj->_trylock = _rmcs_trylock;
+            break;
+        case LOCK_TYPE_BIASED_MCS:
+            atomic_init(&pimpl->impl.mcs_lock.tail, NULL);
+            pimpl->impl.mcs_lock.holder = NULL;
+            bias_init(pimpl);
+            obj->_lock = _bmcs_lock;
+            obj->unlock = _bmcs_unlock;
+            obj->_trylock = _bmcs_trylock;
+            break;
+        case LOCK_TYPE_MCS_TP:
+            atomic_init(&pimpl->impl.mcs_lock.tail, NULL);
+            atomic_init(&pimpl->impl.mcs_lock.cs_start, 0);
+            pimpl->impl.mcs_lock.holder = NULL;
+            obj->_lock = _mcs_tp_lock;
+            obj->unlock = _mcs_tp_unlock;
+            obj->_trylock = _mcs_tp_trylock;
+            break;
+        case LOCK_TYPE_QSPINLOCK:
+            qspin_init(&pimpl->impl.qspin);
+            obj->_lock = _qspin_lock;
+            obj->unlock = _qspin_unlock;
+            obj->_trylock = _qspin_trylock;
             break;
         case LOCK_TYPE_CLH:
-            atomic_init(&pimpl->impl.clh_lock_tail, NULL);
-            obj->_lock = _clh_lock;
-            obj->unlock = _clh_unlock;
+        case LOCK_TYPE_RECURSIVE_CLH: {
+            // The queue always holds one released node so waiters never see an empty tail.
+            clh_qnode_t *dummy = aligned_alloc(CACHE_LINE, sizeof(clh_qnode_t));
+            if (!dummy) {
+                free(obj);
+                free(pimpl);
+                return NULL;
+            }
+            atomic_init(&dummy->locked, false);
+            dummy->next_free = NULL;
+            atomic_init(&pimpl->impl.clh_lock.tail, (uint64_t) (uintptr_t) dummy);
+            pimpl->impl.clh_lock.holder = NULL;
+            bool recursive = type == LOCK_TYPE_RECURSIVE_CLH;
+            obj->_lock = recursive ? _rclh_lock : _clh_lock;
+            obj->unlock = recursive ? _rclh_unlock : _clh_unlock;
+            obj->_trylock = recursive ? _rclh_trylock : _clh_trylock;
             break;
+        }
         default:
             free(obj);
             free(pimpl);
             return NULL;
     }
-    obj->_trylock = NULL;
     return obj;
 }
 
@@ -158,10 +355,21 @@ void destroy_lock_object(lock_t *lock_obj) {
     if (pimpl && pimpl->type == LOCK_TYPE_PTHREAD_MUTEX) {
         pthread_mutex_destroy(&pimpl->impl.p_mutex);
     }
+    if (pimpl && (pimpl->type == LOCK_TYPE_CLH || pimpl->type == LOCK_TYPE_RECURSIVE_CLH)) {
+        // The lock owns whichever node is left at the tail once it is released.
+        free((clh_qnode_t *) (uintptr_t) (atomic_load_explicit(&pimpl->impl.clh_lock.tail, memory_order_relaxed) &
+                                          CLH_PTR_MASK));
+    }
     free(pimpl);
     free(lock_obj);
 }
 
+unsigned long long lock_bias_revocations(lock_t *lock_obj) {
+    lock_impl_t *p = lock_obj->pimpl;
+    if (p->type != LOCK_TYPE_BIASED_TICKET && p->type != LOCK_TYPE_BIASED_MCS) return 0;
+    return atomic_load_explicit(&p->bias.revocations, memory_order_relaxed);
+}
+
 void release_all_locks_held_by_thread(void) {
     while (thread_held_locks_head_c) {
         thread_held_locks_head_c->lock_obj->unlock(thread_held_locks_head_c->lock_obj);
@@ -181,6 +389,13 @@ static void _mutex_unlock(lock_t *self) {
     pthread_mutex_unlock(&p->impl.p_mutex);
 }
 
+static bool _mutex_trylock(lock_t *self, const char *f, int l) {
+    (void) f;
+    (void) l;
+    lock_impl_t *p = self->pimpl;
+    return pthread_mutex_trylock(&p->impl.p_mutex) == 0;
+}
+
 static void _ticket_lock(lock_t *self, const char *f, int l) {
     (void) f;
     (void) l;
@@ -194,61 +409,594 @@ static void _ticket_unlock(lock_t *self) {
     atomic_fetch_add_explicit(&p->impl.ticket_lock.now_serving, 1, memory_order_release);
 }
 
+static bool _ticket_trylock(lock_t *self, const char *f, int l) {
+    (void) f;
+    (void) l;
+    lock_impl_t *p = self->pimpl;
+    // Only take a ticket if it would be served immediately.
+    unsigned int t = atomic_load_explicit(&p->impl.ticket_lock.now_serving, memory_order_relaxed);
+    return atomic_compare_exchange_strong_explicit(&p->impl.ticket_lock.next_ticket, &t, t + 1,
+                                                   memory_order_acquire, memory_order_relaxed);
+}
+
+static mcs_qnode_t *mcs_take_node(void) {
+    unsigned int busy = thread_mcs_qnodes_busy_c;
+    mcs_qnode_t *node;
+    if (busy != (1u << MCS_MAX_NESTING) - 1) {
+        int idx = __builtin_ctz(~busy);
+        thread_mcs_qnodes_busy_c = busy | (1u << idx);
+        node = &thread_mcs_qnodes_c[idx];
+    } else {
+        node = aligned_alloc(CACHE_LINE, sizeof(mcs_qnode_t));
+        if (!node) exit(1);
+    }
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    atomic_store_explicit(&node->locked, true, memory_order_relaxed);
+    return node;
+}
+
+static void mcs_return_node(mcs_qnode_t *node) {
+    if (node >= thread_mcs_qnodes_c && node < thread_mcs_qnodes_c + MCS_MAX_NESTING) {
+        thread_mcs_qnodes_busy_c &= ~(1u << (node - thread_mcs_qnodes_c));
+    } else {
+        free(node);
+    }
+}
+
 static void _mcs_lock(lock_t *self, const char *f, int l) {
     (void) f;
     (void) l;
     lock_impl_t *p = self->pimpl;
-    thread_mcs_qnode_c.next = NULL;
-    atomic_store_explicit(&thread_mcs_qnode_c.locked, true, memory_order_relaxed);
-    mcs_qnode_t *pred = atomic_exchange_explicit(&p->impl.mcs_lock, &thread_mcs_qnode_c, memory_order_acq_rel);
+    mcs_qnode_t *node = mcs_take_node();
+    mcs_qnode_t *pred = atomic_exchange_explicit(&p->impl.mcs_lock.tail, node, memory_order_acq_rel);
     if (pred) {
-        atomic_store_explicit(&pred->next, &thread_mcs_qnode_c, memory_order_release);
-        while (atomic_load_explicit(&thread_mcs_qnode_c.locked, memory_order_acquire)) sched_yield();
+        atomic_store_explicit(&pred->next, node, memory_order_release);
+        while (atomic_load_explicit(&node->locked, memory_order_acquire)) sched_yield();
     }
+    p->impl.mcs_lock.holder = node;
 }
 
 static void _mcs_unlock(lock_t *self) {
     lock_impl_t *p = self->pimpl;
-    mcs_qnode_t *succ = atomic_load_explicit(&thread_mcs_qnode_c.next, memory_order_acquire);
+    mcs_qnode_t *me = p->impl.mcs_lock.holder;
+    mcs_qnode_t *succ = atomic_load_explicit(&me->next, memory_order_acquire);
     if (!succ) {
-        mcs_qnode_t *me = &thread_mcs_qnode_c;
-        if (atomic_compare_exchange_strong_explicit(&p->impl.mcs_lock, &me, NULL, memory_order_release,
-                                                    memory_order_relaxed)) return;
-        while (!(succ = atomic_load_explicit(&thread_mcs_qnode_c.next, memory_order_acquire))) sched_yield();
+        mcs_qnode_t *expected = me;
+        if (atomic_compare_exchange_strong_explicit(&p->impl.mcs_lock.tail, &expected, NULL, memory_order_release,
+                                                    memory_order_relaxed)) {
+            mcs_return_node(me);
+            return;
+        }
+        while (!(succ = atomic_load_explicit(&me->next, memory_order_acquire))) sched_yield();
     }
     atomic_store_explicit(&succ->locked, false, memory_order_release);
+    mcs_return_node(me);
 }
 
-// --- CORRECTED CLH IMPLEMENTATION ---
-static void _clh_lock(lock_t *self, const char *f, int l) {
+static bool _mcs_trylock(lock_t *self, const char *f, int l) {
     (void) f;
     (void) l;
     lock_impl_t *p = self->pimpl;
+    mcs_qnode_t *node = mcs_take_node();
+    mcs_qnode_t *expected = NULL;
+    if (atomic_compare_exchange_strong_explicit(&p->impl.mcs_lock.tail, &expected, node, memory_order_acq_rel,
+                                                memory_order_relaxed)) {
+        p->impl.mcs_lock.holder = node;
+        return true;
+    }
+    mcs_return_node(node);
+    return false;
+}
+
+// --- TIME-PUBLISHED MCS IMPLEMENTATION ---
+// Waiters publish a heartbeat while they spin. The releaser hands the lock only to a
+// waiter whose heartbeat is fresh and unlinks the ones that look preempted; those
+// requeue when they next run. Waiters that see the holder's critical section run far
+// past normal park on a futex rather than burning the holder's CPU time.
+static inline uint64_t tp_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
 
-    // One-time initialization of thread-local pointers at runtime
-    if (my_clh_node_c == NULL) {
-        my_clh_node_c = &clh_node_A_c;
-        next_clh_node_c = &clh_node_B_c;
+static inline void tp_futex(_Atomic unsigned int *word, int op, unsigned int val) {
+    syscall(SYS_futex, word, op, val, NULL, NULL, 0);
+}
+
+static unsigned int tp_wait(lock_impl_t *p, mcs_qnode_t *node) {
+    for (;;) {
+        unsigned int state = atomic_load_explicit(&node->tp_state, memory_order_acquire);
+        if (state == TP_GRANTED || state == TP_SKIPPED) return state;
+        if (state == TP_PARKED) {
+            tp_futex(&node->tp_state, FUTEX_WAIT_PRIVATE, TP_PARKED);
+            continue;
+        }
+        uint64_t now = tp_now_ns();
+        atomic_store_explicit(&node->tp_heartbeat, now, memory_order_relaxed);
+        uint64_t cs_start = atomic_load_explicit(&p->impl.mcs_lock.cs_start, memory_order_relaxed);
+        if (now - cs_start > TP_HOLDER_PATIENCE_NS) {
+            // The holder looks preempted. A failed CAS means we were just granted or skipped.
+            unsigned int expected = TP_WAITING;
+            atomic_compare_exchange_strong_explicit(&node->tp_state, &expected, TP_PARKED,
+                                                    memory_order_acq_rel, memory_order_acquire);
+            continue;
+        }
+        sched_yield();
     }
+}
 
-    // Swap nodes to prevent race condition on immediate re-lock by the same thread
-    clh_qnode_t *temp = my_clh_node_c;
-    my_clh_node_c = next_clh_node_c;
-    next_clh_node_c = temp;
+static void _mcs_tp_lock(lock_t *self, const char *f, int l) {
+    (void) f;
+    (void) l;
+    lock_impl_t *p = self->pimpl;
+    mcs_qnode_t *node;
+    for (;;) {
+        node = mcs_take_node();
+        atomic_store_explicit(&node->tp_state, TP_WAITING, memory_order_relaxed);
+        atomic_store_explicit(&node->tp_heartbeat, tp_now_ns(), memory_order_relaxed);
+        mcs_qnode_t *pred = atomic_exchange_explicit(&p->impl.mcs_lock.tail, node, memory_order_acq_rel);
+        if (!pred) break;
+        atomic_store_explicit(&pred->next, node, memory_order_release);
+        if (tp_wait(p, node) == TP_GRANTED) break;
+        // Skipped: the releaser no longer references our node, so it is free to requeue.
+        mcs_return_node(node);
+    }
+    atomic_store_explicit(&p->impl.mcs_lock.cs_start, tp_now_ns(), memory_order_relaxed);
+    p->impl.mcs_lock.holder = node;
+}
 
-    atomic_store_explicit(&my_clh_node_c->locked, true, memory_order_relaxed);
-    clh_qnode_t *pred = atomic_exchange_explicit(&p->impl.clh_lock_tail, my_clh_node_c, memory_order_acq_rel);
-    if (pred) {
-        while (atomic_load_explicit(&pred->locked, memory_order_acquire)) {
-            sched_yield();
+static bool _mcs_tp_trylock(lock_t *self, const char *f, int l) {
+    // Taking an empty queue publishes no waiter state; only the holder timestamp is needed.
+    if (!_mcs_trylock(self, f, l)) return false;
+    lock_impl_t *p = self->pimpl;
+    atomic_store_explicit(&p->impl.mcs_lock.cs_start, tp_now_ns(), memory_order_relaxed);
+    return true;
+}
+
+// Sets a waiter's final state. The node may be reused as soon as the exchange lands,
+// so the wake-up is decided from the exchanged value alone.
+static inline void tp_resolve(mcs_qnode_t *node, unsigned int state) {
+    if (atomic_exchange_explicit(&node->tp_state, state, memory_order_acq_rel) == TP_PARKED) {
+        tp_futex(&node->tp_state, FUTEX_WAKE_PRIVATE, 1);
+    }
+}
+
+static inline bool tp_looks_preempted(mcs_qnode_t *node, uint64_t now) {
+    // Parked waiters are blocked by choice and cheap to wake, never skip them.
+    return atomic_load_explicit(&node->tp_state, memory_order_relaxed) == TP_WAITING &&
+           now - atomic_load_explicit(&node->tp_heartbeat, memory_order_relaxed) > TP_WAITER_PATIENCE_NS;
+}
+
+static void _mcs_tp_unlock(lock_t *self) {
+    lock_impl_t *p = self->pimpl;
+    mcs_qnode_t *me = p->impl.mcs_lock.holder;
+    mcs_qnode_t *succ = atomic_load_explicit(&me->next, memory_order_acquire);
+    if (!succ) {
+        mcs_qnode_t *expected = me;
+        if (atomic_compare_exchange_strong_explicit(&p->impl.mcs_lock.tail, &expected, NULL, memory_order_release,
+                                                    memory_order_relaxed)) {
+            mcs_return_node(me);
+            return;
+        }
+        while (!(succ = atomic_load_explicit(&me->next, memory_order_acquire))) sched_yield();
+    }
+
+    uint64_t now = tp_now_ns();
+    while (tp_looks_preempted(succ, now)) {
+        // Read the link before skipping: once skipped, succ may requeue and reset it.
+        mcs_qnode_t *next = atomic_load_explicit(&succ->next, memory_order_acquire);
+        if (!next) {
+            mcs_qnode_t *expected = succ;
+            if (atomic_compare_exchange_strong_explicit(&p->impl.mcs_lock.tail, &expected, NULL,
+                                                        memory_order_release, memory_order_relaxed)) {
+                // Every remaining waiter was skipped; the lock is now free.
+                tp_resolve(succ, TP_SKIPPED);
+                mcs_return_node(me);
+                return;
+            }
+            while (!(next = atomic_load_explicit(&succ->next, memory_order_acquire))) sched_yield();
         }
+        tp_resolve(succ, TP_SKIPPED);
+        succ = next;
     }
+    tp_resolve(succ, TP_GRANTED);
+    mcs_return_node(me);
+}
+
+// --- QSPINLOCK IMPLEMENTATION ---
+// The algorithm lives in qspinlock.c so the four-byte lock can also be embedded directly.
+static void _qspin_lock(lock_t *self, const char *f, int l) {
+    (void) f;
+    (void) l;
+    lock_impl_t *p = self->pimpl;
+    qspin_lock(&p->impl.qspin);
+}
+
+static void _qspin_unlock(lock_t *self) {
+    lock_impl_t *p = self->pimpl;
+    qspin_unlock(&p->impl.qspin);
+}
+
+static bool _qspin_trylock(lock_t *self, const char *f, int l) {
+    (void) f;
+    (void) l;
+    lock_impl_t *p = self->pimpl;
+    return qspin_trylock(&p->impl.qspin);
+}
+
+// --- CLH IMPLEMENTATION ---
+static inline void clh_orphan_acquire(void) {
+    while (atomic_flag_test_and_set_explicit(&clh_orphan_busy_c, memory_order_acquire)) sched_yield();
+}
+
+static inline void clh_orphan_release(void) {
+    atomic_flag_clear_explicit(&clh_orphan_busy_c, memory_order_release);
+}
+
+static void clh_orphan_thread_nodes(void *unused) {
+    (void) unused;
+    if (!clh_free_nodes_c) return;
+    clh_qnode_t *last = clh_free_nodes_c;
+    while (last->next_free) last = last->next_free;
+    clh_orphan_acquire();
+    last->next_free = clh_orphan_nodes_c;
+    clh_orphan_nodes_c = clh_free_nodes_c;
+    clh_orphan_release();
+    clh_free_nodes_c = NULL;
+}
+
+static void clh_create_exit_key(void) {
+    pthread_key_create(&clh_exit_key_c, clh_orphan_thread_nodes);
+}
+
+// A thread's free list only runs dry before its first acquisition (each acquisition takes
+// one node and adopts one), so the orphan flag is off the hot path.
+static clh_qnode_t *clh_take_node(void) {
+    clh_qnode_t *node = clh_free_nodes_c;
+    if (node) {
+        clh_free_nodes_c = node->next_free;
+        return node;
+    }
+    if (!clh_exit_hook_armed_c) {
+        // Any non-NULL value makes the key destructor run when this thread exits.
+        pthread_once(&clh_exit_once_c, clh_create_exit_key);
+        pthread_setspecific(clh_exit_key_c, &clh_exit_hook_armed_c);
+        clh_exit_hook_armed_c = true;
+    }
+    clh_orphan_acquire();
+    node = clh_orphan_nodes_c;
+    if (node) clh_orphan_nodes_c = node->next_free;
+    clh_orphan_release();
+    if (node) return node;
+    node = aligned_alloc(CACHE_LINE, sizeof(clh_qnode_t));
+    if (!node) exit(1);
+    return node;
+}
+
+static void clh_return_node(clh_qnode_t *node) {
+    node->next_free = clh_free_nodes_c;
+    clh_free_nodes_c = node;
+}
+
+static inline clh_qnode_t *clh_tail_node(uint64_t tail) {
+    return (clh_qnode_t *) (uintptr_t) (tail & CLH_PTR_MASK);
+}
+
+static inline uint64_t clh_next_tail(uint64_t tail, clh_qnode_t *node) {
+    return ((tail & ~CLH_PTR_MASK) + (1ull << CLH_PTR_BITS)) | (uint64_t) (uintptr_t) node;
+}
+
+static void _clh_lock(lock_t *self, const char *f, int l) {
+    (void) f;
+    (void) l;
+    lock_impl_t *p = self->pimpl;
+
+    clh_qnode_t *node = clh_take_node();
+    atomic_store_explicit(&node->locked, true, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&p->impl.clh_lock.tail, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&p->impl.clh_lock.tail, &tail, clh_next_tail(tail, node),
+                                                  memory_order_acq_rel, memory_order_relaxed)) {
+    }
+    clh_qnode_t *pred = clh_tail_node(tail);
+    while (atomic_load_explicit(&pred->locked, memory_order_acquire)) {
+        sched_yield();
+    }
+    // Nobody else references the predecessor's node any more; adopt it.
+    clh_return_node(pred);
+    p->impl.clh_lock.holder = node;
 }
 
 static void _clh_unlock(lock_t *self) {
-    (void) self;
-    // Unlock the node that our successor is spinning on. No deallocation needed.
-    if (my_clh_node_c) {
-        atomic_store_explicit(&my_clh_node_c->locked, false, memory_order_release);
+    lock_impl_t *p = self->pimpl;
+    // Our successor spins on this node and will adopt it once it sees the release.
+    atomic_store_explicit(&p->impl.clh_lock.holder->locked, false, memory_order_release);
+}
+
+static bool _clh_trylock(lock_t *self, const char *f, int l) {
+    (void) f;
+    (void) l;
+    lock_impl_t *p = self->pimpl;
+    uint64_t tail = atomic_load_explicit(&p->impl.clh_lock.tail, memory_order_acquire);
+    clh_qnode_t *pred = clh_tail_node(tail);
+    // The tail node is still locked, so the lock is held or queued on.
+    if (atomic_load_explicit(&pred->locked, memory_order_acquire)) return false;
+
+    clh_qnode_t *node = clh_take_node();
+    atomic_store_explicit(&node->locked, true, memory_order_relaxed);
+    // Fails if anyone enqueued since we read the tail, even with a recycled node at the same address.
+    if (atomic_compare_exchange_strong_explicit(&p->impl.clh_lock.tail, &tail, clh_next_tail(tail, node),
+                                                memory_order_acq_rel, memory_order_relaxed)) {
+        clh_return_node(pred);
+        p->impl.clh_lock.holder = node;
+        return true;
+    }
+    // Our node was never published, so it can go straight back to the free list.
+    clh_return_node(node);
+    return false;
+}
+
+// --- RECURSIVE IMPLEMENTATIONS ---
+// Each wraps the plain lock of the same family. Re-entry is recognized by comparing the
+// owner tag with our own: only this thread ever stores its tag, so a relaxed load is
+// enough and a nested acquire or release costs no atomic read-modify-write.
+static inline uint32_t current_owner_tag(void) {
+    if (__builtin_expect(thread_owner_tag_c == 0, 0)) {
+        thread_owner_tag_c = atomic_fetch_add_explicit(&next_owner_tag_c, 1, memory_order_relaxed);
+    }
+    return thread_owner_tag_c;
+}
+
+static inline bool recursive_reenter(lock_impl_t *p, uint32_t tag) {
+    if (atomic_load_explicit(&p->owner, memory_order_relaxed) != tag) return false;
+    ++p->depth;
+    return true;
+}
+
+static inline void recursive_take(lock_impl_t *p, uint32_t tag) {
+    atomic_store_explicit(&p->owner, tag, memory_order_relaxed);
+    p->depth = 1;
+}
+
+// Returns true once the outermost acquisition is released and the inner lock must be too.
+static inline bool recursive_release(lock_impl_t *p) {
+    if (--p->depth > 0) return false;
+    atomic_store_explicit(&p->owner, 0, memory_order_relaxed);
+    return true;
+}
+
+static void _rticket_lock(lock_t *self, const char *f, int l) {
+    uint32_t tag = current_owner_tag();
+    if (recursive_reenter(self->pimpl, tag)) return;
+    _ticket_lock(self, f, l);
+    recursive_take(self->pimpl, tag);
+}
+
+static void _rticket_unlock(lock_t *self) {
+    if (recursive_release(self->pimpl)) _ticket_unlock(self);
+}
+
+static bool _rticket_trylock(lock_t *self, const char *f, int l) {
+    uint32_t tag = current_owner_tag();
+    if (recursive_reenter(self->pimpl, tag)) return true;
+    if (!_ticket_trylock(self, f, l)) return false;
+    recursive_take(self->pimpl, tag);
+    return true;
+}
+
+static void _rmcs_lock(lock_t *self, const char *f, int l) {
+    uint32_t tag = current_owner_tag();
+    if (recursive_reenter(self->pimpl, tag)) return;
+    _mcs_lock(self, f, l);
+    recursive_take(self->pimpl, tag);
+}
+
+static void _rmcs_unlock(lock_t *self) {
+    if (recursive_release(self->pimpl)) _mcs_unlock(self);
+}
+
+static bool _rmcs_trylock(lock_t *self, const char *f, int l) {
+    uint32_t tag = current_owner_tag();
+    if (recursive_reenter(self->pimpl, tag)) return true;
+    if (!_mcs_trylock(self, f, l)) return false;
+    recursive_take(self->pimpl, tag);
+    return true;
+}
+
+static void _rclh_lock(lock_t *self, const char *f, int l) {
+    uint32_t tag = current_owner_tag();
+    if (recursive_reenter(self->pimpl, tag)) return;
+    _clh_lock(self, f, l);
+    recursive_take(self->pimpl, tag);
+}
+
+static void _rclh_unlock(lock_t *self) {
+    if (recursive_release(self->pimpl)) _clh_unlock(self);
+}
+
+static bool _rclh_trylock(lock_t *self, const char *f, int l) {
+    uint32_t tag = current_owner_tag();
+    if (recursive_reenter(self->pimpl, tag)) return true;
+    if (!_clh_trylock(self, f, l)) return false;
+    recursive_take(self->pimpl, tag);
+    return true;
+}
+
+// --- BIASED IMPLEMENTATIONS ---
+// The first thread to lock a biased lock owns its bias and afterwards acquires it by setting
+// in_cs and re-reading the bias word. Any other thread first takes the fallback lock, then
+// revokes: it publishes BIAS_REVOKED, issues a full fence on the owner's behalf and waits for
+// in_cs to drop. This is Dekker's handshake with an asymmetric fence, so the owner needs only
+// a compiler barrier when expedited membarrier is available.
+static bool bias_light_fence = false;
+static pthread_once_t bias_once = PTHREAD_ONCE_INIT;
+
+static void bias_register_membarrier(void) {
+#ifdef __NR_membarrier
+    bias_light_fence = syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+#endif
+}
+
+static void bias_init(lock_impl_t *p) {
+    // Done at creation so every thread that later uses the lock agrees on the fence protocol.
+    pthread_once(&bias_once, bias_register_membarrier);
+    atomic_init(&p->bias.state, BIAS_UNBIASED);
+    atomic_init(&p->bias.in_cs, 0);
+    p->bias.fast_held = false;
+    p->bias.streak_owner = 0;
+    p->bias.streak = 0;
+    atomic_init(&p->bias.revocations, 0);
+}
+
+static bool bias_try_fast(lock_impl_t *p, uint32_t tag) {
+    uint64_t mine = BIAS_TOWARDS(tag);
+    uint64_t state = atomic_load_explicit(&p->bias.state, memory_order_relaxed);
+    if (state != mine) {
+        // Only a lock nobody has used yet can be claimed outside the fallback lock.
+        if (state != BIAS_UNBIASED ||
+            !atomic_compare_exchange_strong_explicit(&p->bias.state, &state, mine, memory_order_acq_rel,
+                                                     memory_order_relaxed)) {
+            return false;
+        }
+    }
+    atomic_store_explicit(&p->bias.in_cs, 1, memory_order_relaxed);
+    if (bias_light_fence) atomic_signal_fence(memory_order_seq_cst);
+    else atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&p->bias.state, memory_order_acquire) == mine) {
+        p->bias.fast_held = true;
+        return true;
+    }
+    // A revoker got in first and may be waiting for us.
+    atomic_store_explicit(&p->bias.in_cs, 0, memory_order_release);
+    return false;
+}
+
+// Called with the fallback lock held: makes sure no bias owner can enter through the fast path.
+// Without wait, returns false instead of waiting for an owner that is inside its critical
+// section; the revocation stays published, so the owner cannot enter again.
+static bool bias_settle(lock_impl_t *p, uint32_t tag, bool wait) {
+    uint64_t state = atomic_load_explicit(&p->bias.state, memory_order_acquire);
+    while (state != BIAS_REVOKED) {
+        if (state == BIAS_TOWARDS(tag)) {
+            // We own the bias, so nobody else can be in the fast path.
+            p->bias.fast_held = false;
+            return true;
+        }
+        if (!atomic_compare_exchange_weak_explicit(&p->bias.state, &state, BIAS_REVOKED, memory_order_seq_cst,
+                                                   memory_order_acquire)) {
+            continue;
+        }
+#ifdef __NR_membarrier
+        if (!bias_light_fence || syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0) != 0)
+#endif
+            atomic_thread_fence(memory_order_seq_cst);
+        if (state != BIAS_UNBIASED) atomic_fetch_add_explicit(&p->bias.revocations, 1, memory_order_relaxed);
+        break;
+    }
+    // Also checked when the lock was already revoked: a trylock that gave up here left the
+    // owner it revoked inside its critical section.
+    while (atomic_load_explicit(&p->bias.in_cs, memory_order_acquire)) {
+        if (!wait) return false;
+        sched_yield();
+    }
+    p->bias.fast_held = false;
+    return true;
+}
+
+// A biased lock is not reentrant. Unlike a plain lock, re-acquiring it would not deadlock
+// but let the owner in twice through the fast path and corrupt the fallback lock on release.
+// lock() asserts against that in debug builds; with NDEBUG it is undefined, like re-locking
+// a PTHREAD_MUTEX_NORMAL mutex.
+static inline bool bias_held_by(lock_impl_t *p, uint32_t tag) {
+    return atomic_load_explicit(&p->owner, memory_order_relaxed) == tag;
+}
+
+// Returns true if the lock was held through the fast path and is now released.
+static bool bias_fast_unlock(lock_impl_t *p) {
+    atomic_store_explicit(&p->owner, 0, memory_order_relaxed);
+    if (!p->bias.fast_held) return false;
+    p->bias.fast_held = false;
+    atomic_store_explicit(&p->bias.in_cs, 0, memory_order_release);
+    return true;
+}
+
+// Called with the fallback lock held, just before releasing it.
+static void bias_before_release(lock_impl_t *p) {
+    if (atomic_load_explicit(&p->bias.state, memory_order_relaxed) != BIAS_REVOKED) return;
+    uint32_t tag = current_owner_tag();
+    if (p->bias.streak_owner != tag) {
+        p->bias.streak_owner = tag;
+        p->bias.streak = 0;
+    }
+    if (++p->bias.streak >= BIAS_REBIAS_AFTER) {
+        // Nobody else has needed the lock for a while. Threads that queue for the fallback
+        // lock behind us will find the new bias in bias_settle() and revoke it again.
+        p->bias.streak = 0;
+        atomic_store_explicit(&p->bias.state, BIAS_TOWARDS(tag), memory_order_release);
+    }
+}
+
+static void _bticket_lock(lock_t *self, const char *f, int l) {
+    lock_impl_t *p = self->pimpl;
+    uint32_t tag = current_owner_tag();
+    assert(!bias_held_by(p, tag) && "biased lock re-acquired by the thread that holds it");
+    if (!bias_try_fast(p, tag)) {
+        _ticket_lock(self, f, l);
+        bias_settle(p, tag, true);
+    }
+    atomic_store_explicit(&p->owner, tag, memory_order_relaxed);
+}
+
+static void _bticket_unlock(lock_t *self) {
+    if (bias_fast_unlock(self->pimpl)) return;
+    bias_before_release(self->pimpl);
+    _ticket_unlock(self);
+}
+
+static bool _bticket_trylock(lock_t *self, const char *f, int l) {
+    lock_impl_t *p = self->pimpl;
+    uint32_t tag = current_owner_tag();
+    if (bias_held_by(p, tag)) return false;
+    if (!bias_try_fast(p, tag)) {
+        if (!_ticket_trylock(self, f, l)) return false;
+        if (!bias_settle(p, tag, false)) {
+            // The bias owner is inside its critical section; it will take the fallback lock next time.
+            _ticket_unlock(self);
+            return false;
+        }
+    }
+    atomic_store_explicit(&p->owner, tag, memory_order_relaxed);
+    return true;
+}
+
+static void _bmcs_lock(lock_t *self, const char *f, int l) {
+    lock_impl_t *p = self->pimpl;
+    uint32_t tag = current_owner_tag();
+    assert(!bias_held_by(p, tag) && "biased lock re-acquired by the thread that holds it");
+    if (!bias_try_fast(p, tag)) {
+        _mcs_lock(self, f, l);
+        bias_settle(p, tag, true);
+    }
+    atomic_store_explicit(&p->owner, tag, memory_order_relaxed);
+}
+
+static void _bmcs_unlock(lock_t *self) {
+    if (bias_fast_unlock(self->pimpl)) return;
+    bias_before_release(self->pimpl);
+    _mcs_unlock(self);
+}
+
+static bool _bmcs_trylock(lock_t *self, const char *f, int l) {
+    lock_impl_t *p = self->pimpl;
+    uint32_t tag = current_owner_tag();
+    if (bias_held_by(p, tag)) return false;
+    if (!bias_try_fast(p, tag)) {
+        if (!_mcs_trylock(self, f, l)) return false;
+        if (!bias_settle(p, tag, false)) {
+            // The bias owner is inside its critical section; it will take the fallback lock next time.
+            _mcs_unlock(self);
+            return false;
+        }
     }
+    atomic_store_explicit(&p->owner, tag, memory_order_relaxed);
+    return true;
 }
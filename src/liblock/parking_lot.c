@@ -0,0 +1,165 @@
+#define _GNU_SOURCE
+#include "parking_lot.h"
+#include <sched.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // For _mm_pause
+#endif
+
+#define CACHE_LINE 64
+#define BUCKET_LOCK_SPINS 64 // Pauses before a thread waiting for a bucket yields its CPU
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__)
+#define CPU_RELAX() __asm__ __volatile__ ("yield" ::: "memory")
+#else
+#define CPU_RELAX() sched_yield() // Fallback for other architectures
+#endif
+
+// --- Buckets ---
+// A parked thread's record lives on its own stack for as long as it is parked.
+typedef struct parking_waiter_s {
+    const void *addr;
+    struct parking_waiter_s *next;
+    intptr_t token;
+    _Atomic unsigned int woken; // Futex word; set once the waiter has been dequeued
+} parking_waiter_t;
+
+typedef struct __attribute__((aligned(CACHE_LINE))) {
+    _Atomic int lock; // Held only while the queue is inspected or changed
+    parking_waiter_t *head;
+    parking_waiter_t *tail;
+    uint64_t next_fair_ns;
+} parking_bucket_t;
+
+static parking_bucket_t parking_buckets[PARKING_LOT_BUCKETS];
+
+static inline parking_bucket_t *parking_bucket(const void *addr) {
+    uint64_t h = (uint64_t) (uintptr_t) addr * 0x9E3779B97F4A7C15ull;
+    return &parking_buckets[(h >> 32) % PARKING_LOT_BUCKETS];
+}
+
+static void bucket_lock(parking_bucket_t *b) {
+    for (int spins = 0; atomic_exchange_explicit(&b->lock, 1, memory_order_acquire); ++spins) {
+        while (atomic_load_explicit(&b->lock, memory_order_relaxed)) {
+            if (spins++ < BUCKET_LOCK_SPINS) CPU_RELAX();
+            else sched_yield();
+        }
+    }
+}
+
+static inline void bucket_unlock(parking_bucket_t *b) {
+    atomic_store_explicit(&b->lock, 0, memory_order_release);
+}
+
+static inline uint64_t parking_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static inline void parking_futex(_Atomic unsigned int *word, int op, unsigned int val) {
+    syscall(SYS_futex, word, op, val, NULL, NULL, 0);
+}
+
+static void parking_wake(parking_waiter_t *w, intptr_t token) {
+    w->token = token;
+    atomic_store_explicit(&w->woken, 1, memory_order_release);
+    // w may already be gone; a stray wake on its old stack slot is harmless to futex users.
+    parking_futex(&w->woken, FUTEX_WAKE_PRIVATE, 1);
+}
+
+// --- Public API ---
+bool parking_lot_park(const void *addr, parking_validate_fn validate, void *ctx, intptr_t *token) {
+    parking_waiter_t me = { .addr = addr, .next = NULL, .token = 0 };
+    atomic_init(&me.woken, 0);
+
+    parking_bucket_t *b = parking_bucket(addr);
+    bucket_lock(b);
+    if (validate && !validate(ctx)) {
+        bucket_unlock(b);
+        return false;
+    }
+    if (b->tail) b->tail->next = &me;
+    else b->head = &me;
+    b->tail = &me;
+    bucket_unlock(b);
+
+    while (!atomic_load_explicit(&me.woken, memory_order_acquire)) {
+        parking_futex(&me.woken, FUTEX_WAIT_PRIVATE, 0);
+    }
+    if (token) *token = me.token;
+    return true;
+}
+
+parking_unpark_result_t parking_lot_unpark_one(const void *addr, parking_unpark_fn callback, void *ctx) {
+    parking_unpark_result_t result = { false, false, false };
+    parking_bucket_t *b = parking_bucket(addr);
+    bucket_lock(b);
+
+    parking_waiter_t *prev = NULL, *w = b->head;
+    while (w && w->addr != addr) {
+        prev = w;
+        w = w->next;
+    }
+    if (w) {
+        if (prev) prev->next = w->next;
+        else b->head = w->next;
+        if (b->tail == w) b->tail = prev;
+        result.did_unpark_thread = true;
+        for (parking_waiter_t *rest = w->next; rest; rest = rest->next) {
+            if (rest->addr == addr) {
+                result.may_have_more_threads = true;
+                break;
+            }
+        }
+        // Randomize the interval so locks sharing a bucket do not turn fair in lockstep.
+        uint64_t now = parking_now_ns();
+        if (now >= b->next_fair_ns) {
+            result.time_to_be_fair = true;
+            b->next_fair_ns = now + ((now * 0x9E3779B97F4A7C15ull) >> 40) % (2 * PARKING_LOT_FAIR_INTERVAL_NS);
+        }
+    }
+    intptr_t token = callback ? callback(result, ctx) : 0;
+    bucket_unlock(b);
+
+    if (w) parking_wake(w, token);
+    return result;
+}
+
+unsigned parking_lot_unpark_all(const void *addr) {
+    parking_bucket_t *b = parking_bucket(addr);
+    parking_waiter_t *woken = NULL, **woken_tail = &woken;
+    bucket_lock(b);
+    parking_waiter_t *prev = NULL, *w = b->head;
+    while (w) {
+        parking_waiter_t *next = w->next;
+        if (w->addr == addr) {
+            if (prev) prev->next = next;
+            else b->head = next;
+            if (b->tail == w) b->tail = prev;
+            w->next = NULL;
+            *woken_tail = w;
+            woken_tail = &w->next;
+        } else {
+            prev = w;
+        }
+        w = next;
+    }
+    bucket_unlock(b);
+
+    unsigned count = 0;
+    while (woken) {
+        parking_waiter_t *next = woken->next; // Read before waking: the record dies with the park
+        parking_wake(woken, 0);
+        woken = next;
+        ++count;
+    }
+    return count;
+}
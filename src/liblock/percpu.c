@@ -0,0 +1,393 @@
+#define _GNU_SOURCE
+#include "percpu.h"
+#include "lock.h"
+#include <sched.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__x86_64__) && defined(__has_include)
+#if __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#if defined(RSEQ_SIG) && defined(__NR_rseq)
+#define PERCPU_HAVE_RSEQ 1
+#endif
+#endif
+#endif
+
+#define CACHE_LINE 64
+
+typedef struct __attribute__((aligned(CACHE_LINE))) {
+    intptr_t word;
+    percpu_node_t *head;
+    lock_t *lock; // Locked mode only
+} percpu_slot_t;
+
+struct percpu_s {
+    percpu_mode_t mode;
+    int nr_cpus;
+    percpu_slot_t *slots;
+};
+
+_Static_assert(offsetof(percpu_node_t, next) == 0, "the rseq pop loads next from offset 0");
+
+#ifdef PERCPU_HAVE_RSEQ
+// --- Registration ---
+// glibc registers one area per thread and publishes its offset from the thread pointer.
+// When it has not (older glibc, or disabled via the glibc.pthread.rseq tunable), the
+// thread registers an area of ours, with the same signature glibc would use.
+static _Thread_local struct rseq percpu_rseq_own;
+static _Thread_local struct rseq *percpu_rseq_c = NULL;
+static _Thread_local bool percpu_rseq_owned_c = false;
+static _Thread_local bool percpu_rseq_failed_c = false;
+
+static struct rseq *percpu_rseq_register_slow(void) {
+    if (percpu_rseq_failed_c) return NULL;
+    if (__rseq_size > 0) {
+        percpu_rseq_c = (struct rseq *) ((char *) __builtin_thread_pointer() + __rseq_offset);
+        return percpu_rseq_c;
+    }
+    percpu_rseq_own.cpu_id = RSEQ_CPU_ID_UNINITIALIZED;
+    if (syscall(__NR_rseq, &percpu_rseq_own, sizeof(percpu_rseq_own), 0, RSEQ_SIG) != 0) {
+        percpu_rseq_failed_c = true;
+        return NULL;
+    }
+    percpu_rseq_owned_c = true;
+    percpu_rseq_c = &percpu_rseq_own;
+    return percpu_rseq_c;
+}
+
+static inline struct rseq *percpu_rseq(void) {
+    if (__builtin_expect(percpu_rseq_c != NULL, 1)) return percpu_rseq_c;
+    return percpu_rseq_register_slow();
+}
+
+// A thread of an rseq-mode object that cannot register would race with the others.
+static inline struct rseq *percpu_rseq_or_die(void) {
+    struct rseq *rs = percpu_rseq();
+    if (!rs) exit(1);
+    return rs;
+}
+
+static inline int percpu_rseq_cpu(struct rseq *rs) {
+    return (int) __atomic_load_n(&rs->cpu_id_start, __ATOMIC_RELAXED);
+}
+
+// --- Critical Sections (x86-64) ---
+// Each section gets a descriptor in __rseq_cs naming its start, its length up to the
+// commit and its abort handler. The section stores the descriptor's address into the
+// thread's rseq area, checks that it still runs on the expected CPU and ends with a
+// single committing store. If the kernel preempts, migrates or signals the thread
+// before the commit, it resumes at the abort handler instead, which must be preceded
+// by the registered signature; the caller then re-reads its CPU and retries.
+#define PERCPU_STR_(x) #x
+#define PERCPU_STR(x) PERCPU_STR_(x)
+
+#define PERCPU_RSEQ_CS_BEGIN                                                   \
+    ".pushsection __rseq_cs, \"aw\"\n\t"                                       \
+    ".balign 32\n\t"                                                           \
+    "3:\n\t"                                                                   \
+    ".long 0x0, 0x0\n\t"                                                       \
+    ".quad 1f, (2f - 1f), 4f\n\t"                                              \
+    ".popsection\n\t"                                                          \
+    ".pushsection __rseq_cs_ptr_array, \"aw\"\n\t"                             \
+    ".quad 3b\n\t"                                                             \
+    ".popsection\n\t"                                                          \
+    "leaq 3b(%%rip), %%rax\n\t"                                                \
+    "movq %%rax, %[rseq_cs]\n\t"                                               \
+    "1:\n\t"                                                                   \
+    "cmpl %[cpu], %[cpu_id]\n\t"                                               \
+    "jnz 4f\n\t"
+
+// The signature is encoded as "ud1 <sig>(%rip), %edi" so disassemblers stay in sync.
+#define PERCPU_RSEQ_CS_END                                                     \
+    "2:\n\t"                                                                   \
+    ".pushsection __rseq_failure, \"ax\"\n\t"                                  \
+    ".byte 0x0f, 0xb9, 0x3d\n\t"                                               \
+    ".long " PERCPU_STR(RSEQ_SIG) "\n\t"                                       \
+    "4:\n\t"                                                                   \
+    "jmp %l[abort]\n\t"                                                        \
+    ".popsection\n\t"
+
+#define PERCPU_RSEQ_ABI_OPERANDS(rs, cpu)                                      \
+    [cpu_id] "m"((rs)->cpu_id), [rseq_cs] "m"((rs)->rseq_cs), [cpu] "r"(cpu)
+
+// Each returns 0 once committed and -1 if the section was aborted.
+static inline int rseq_add(struct rseq *rs, int cpu, intptr_t *v, intptr_t count) {
+    __asm__ __volatile__ goto(
+        PERCPU_RSEQ_CS_BEGIN
+        "addq %[count], %[v]\n\t"
+        PERCPU_RSEQ_CS_END
+        :
+        : PERCPU_RSEQ_ABI_OPERANDS(rs, cpu), [v] "m"(*v), [count] "er"(count)
+        : "memory", "cc", "rax"
+        : abort);
+    return 0;
+abort:
+    return -1;
+}
+
+// Returns 1 if *v did not equal expect.
+static inline int rseq_cmpstore(struct rseq *rs, int cpu, intptr_t *v, intptr_t expect, intptr_t newv) {
+    __asm__ __volatile__ goto(
+        PERCPU_RSEQ_CS_BEGIN
+        "cmpq %[expect], %[v]\n\t"
+        "jnz %l[mismatch]\n\t"
+        "movq %[newv], %[v]\n\t"
+        PERCPU_RSEQ_CS_END
+        :
+        : PERCPU_RSEQ_ABI_OPERANDS(rs, cpu), [v] "m"(*v), [expect] "r"(expect), [newv] "r"(newv)
+        : "memory", "cc", "rax"
+        : abort, mismatch);
+    return 0;
+abort:
+    return -1;
+mismatch:
+    return 1;
+}
+
+// node->next may be written more than once if the section restarts; the node is still ours.
+static inline int rseq_push(struct rseq *rs, int cpu, percpu_node_t **head, percpu_node_t *node) {
+    __asm__ __volatile__ goto(
+        PERCPU_RSEQ_CS_BEGIN
+        "movq %[head], %%rcx\n\t"
+        "movq %%rcx, %[next]\n\t"
+        "movq %[node], %[head]\n\t"
+        PERCPU_RSEQ_CS_END
+        :
+        : PERCPU_RSEQ_ABI_OPERANDS(rs, cpu), [head] "m"(*head), [next] "m"(node->next), [node] "r"(node)
+        : "memory", "cc", "rax", "rcx"
+        : abort);
+    return 0;
+abort:
+    return -1;
+}
+
+// Dereferencing the head is safe: only threads on this CPU pop from this list, and none
+// of them can run between our load and our commit without aborting us.
+static inline int rseq_pop(struct rseq *rs, int cpu, percpu_node_t **head, percpu_node_t **out) {
+    __asm__ __volatile__ goto(
+        PERCPU_RSEQ_CS_BEGIN
+        "movq %[head], %%rcx\n\t"
+        "testq %%rcx, %%rcx\n\t"
+        "jz %l[empty]\n\t"
+        "movq (%%rcx), %%rax\n\t"
+        "movq %%rax, %[head]\n\t"
+        PERCPU_RSEQ_CS_END
+        "movq %%rcx, %[out]\n\t"
+        :
+        : PERCPU_RSEQ_ABI_OPERANDS(rs, cpu), [head] "m"(*head), [out] "m"(*out)
+        : "memory", "cc", "rax", "rcx"
+        : abort, empty);
+    return 0;
+abort:
+    return -1;
+empty:
+    *out = NULL;
+    return 0;
+}
+#endif // PERCPU_HAVE_RSEQ
+
+// --- Registration API ---
+bool percpu_register_thread(void) {
+#ifdef PERCPU_HAVE_RSEQ
+    return percpu_rseq() != NULL;
+#else
+    return false;
+#endif
+}
+
+void percpu_unregister_thread(void) {
+#ifdef PERCPU_HAVE_RSEQ
+    if (percpu_rseq_owned_c) {
+        syscall(__NR_rseq, &percpu_rseq_own, sizeof(percpu_rseq_own), RSEQ_FLAG_UNREGISTER, RSEQ_SIG);
+        percpu_rseq_owned_c = false;
+    }
+    percpu_rseq_c = NULL;
+#endif
+}
+
+int percpu_current_cpu(void) {
+#ifdef PERCPU_HAVE_RSEQ
+    struct rseq *rs = percpu_rseq();
+    if (rs) return percpu_rseq_cpu(rs);
+#endif
+    int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : cpu;
+}
+
+// --- Locked Mode ---
+// Any slot is correct under its lock; the current CPU's just keeps the lock uncontended.
+static inline percpu_slot_t *percpu_locked_slot(percpu_t *pc) {
+    return &pc->slots[(unsigned int) percpu_current_cpu() % (unsigned int) pc->nr_cpus];
+}
+
+// --- Lifecycle ---
+// The kernel's possible mask looks like "0-3,8-11".
+int percpu_possible_cpus(void) {
+    FILE *f = fopen("/sys/devices/system/cpu/possible", "re");
+    if (!f) return -1;
+    long last = -1, lo, hi;
+    char sep;
+    while (fscanf(f, "%ld", &lo) == 1) {
+        hi = lo;
+        if (fscanf(f, "%c", &sep) == 1 && sep == '-' && fscanf(f, "%ld", &hi) == 1) {
+            if (fscanf(f, "%c", &sep) != 1) sep = '\n';
+        }
+        if (hi > last) last = hi;
+        if (sep != ',') break;
+    }
+    fclose(f);
+    return last < 0 ? -1 : (int) last + 1;
+}
+
+percpu_t *percpu_create(lock_type_t fallback, percpu_mode_t mode) {
+    long cpus = percpu_possible_cpus();
+    if (mode == PERCPU_MODE_AUTO) {
+        mode = (cpus > 0 && percpu_register_thread()) ? PERCPU_MODE_RSEQ : PERCPU_MODE_LOCKED;
+    }
+    // rseq indexes slots by CPU id, so it needs a slot for every id the kernel can report.
+    if (mode == PERCPU_MODE_RSEQ && (cpus <= 0 || !percpu_register_thread())) return NULL;
+    // Locked mode takes the CPU id modulo the slot count, so any count is safe.
+    if (cpus <= 0) cpus = sysconf(_SC_NPROCESSORS_CONF);
+    if (cpus <= 0) cpus = 1;
+
+    percpu_t *pc = malloc(sizeof(percpu_t));
+    percpu_slot_t *slots = aligned_alloc(CACHE_LINE, sizeof(percpu_slot_t) * (size_t) cpus);
+    if (!pc || !slots) {
+        free(pc);
+        free(slots);
+        return NULL;
+    }
+    pc->mode = mode;
+    pc->nr_cpus = (int) cpus;
+    pc->slots = slots;
+    for (int i = 0; i < pc->nr_cpus; ++i) {
+        slots[i].word = 0;
+        slots[i].head = NULL;
+        slots[i].lock = NULL;
+    }
+    if (mode == PERCPU_MODE_LOCKED) {
+        for (int i = 0; i < pc->nr_cpus; ++i) {
+            slots[i].lock = create_lock_object(fallback);
+            if (!slots[i].lock) {
+                percpu_destroy(pc);
+                return NULL;
+            }
+        }
+    }
+    return pc;
+}
+
+void percpu_destroy(percpu_t *pc) {
+    if (!pc) return;
+    for (int i = 0; i < pc->nr_cpus; ++i) {
+        if (pc->slots[i].lock) destroy_lock_object(pc->slots[i].lock);
+    }
+    free(pc->slots);
+    free(pc);
+}
+
+percpu_mode_t percpu_mode(percpu_t *pc) {
+    return pc->mode;
+}
+
+int percpu_nr_cpus(percpu_t *pc) {
+    return pc->nr_cpus;
+}
+
+// --- Words ---
+void percpu_add(percpu_t *pc, intptr_t delta) {
+#ifdef PERCPU_HAVE_RSEQ
+    if (pc->mode == PERCPU_MODE_RSEQ) {
+        struct rseq *rs = percpu_rseq_or_die();
+        for (;;) {
+            int cpu = percpu_rseq_cpu(rs);
+            if (rseq_add(rs, cpu, &pc->slots[cpu].word, delta) == 0) return;
+        }
+    }
+#endif
+    percpu_slot_t *s = percpu_locked_slot(pc);
+    lock(s->lock);
+    __atomic_store_n(&s->word, s->word + delta, __ATOMIC_RELAXED);
+    s->lock->unlock(s->lock);
+}
+
+bool percpu_cmpstore(percpu_t *pc, intptr_t expect, intptr_t newv) {
+#ifdef PERCPU_HAVE_RSEQ
+    if (pc->mode == PERCPU_MODE_RSEQ) {
+        struct rseq *rs = percpu_rseq_or_die();
+        for (;;) {
+            int cpu = percpu_rseq_cpu(rs);
+            int ret = rseq_cmpstore(rs, cpu, &pc->slots[cpu].word, expect, newv);
+            if (ret >= 0) return ret == 0;
+        }
+    }
+#endif
+    percpu_slot_t *s = percpu_locked_slot(pc);
+    lock(s->lock);
+    bool stored = s->word == expect;
+    if (stored) __atomic_store_n(&s->word, newv, __ATOMIC_RELAXED);
+    s->lock->unlock(s->lock);
+    return stored;
+}
+
+intptr_t percpu_word(percpu_t *pc, int cpu) {
+    return __atomic_load_n(&pc->slots[cpu].word, __ATOMIC_RELAXED);
+}
+
+intptr_t percpu_sum(percpu_t *pc) {
+    intptr_t sum = 0;
+    for (int i = 0; i < pc->nr_cpus; ++i) {
+        sum += __atomic_load_n(&pc->slots[i].word, __ATOMIC_RELAXED);
+    }
+    return sum;
+}
+
+// --- Lists ---
+void percpu_push(percpu_t *pc, percpu_node_t *node) {
+#ifdef PERCPU_HAVE_RSEQ
+    if (pc->mode == PERCPU_MODE_RSEQ) {
+        struct rseq *rs = percpu_rseq_or_die();
+        for (;;) {
+            int cpu = percpu_rseq_cpu(rs);
+            if (rseq_push(rs, cpu, &pc->slots[cpu].head, node) == 0) return;
+        }
+    }
+#endif
+    percpu_slot_t *s = percpu_locked_slot(pc);
+    lock(s->lock);
+    node->next = s->head;
+    s->head = node;
+    s->lock->unlock(s->lock);
+}
+
+percpu_node_t *percpu_pop(percpu_t *pc) {
+#ifdef PERCPU_HAVE_RSEQ
+    if (pc->mode == PERCPU_MODE_RSEQ) {
+        struct rseq *rs = percpu_rseq_or_die();
+        percpu_node_t *node;
+        for (;;) {
+            int cpu = percpu_rseq_cpu(rs);
+            if (rseq_pop(rs, cpu, &pc->slots[cpu].head, &node) == 0) return node;
+        }
+    }
+#endif
+    percpu_slot_t *s = percpu_locked_slot(pc);
+    lock(s->lock);
+    percpu_node_t *node = s->head;
+    if (node) s->head = node->next;
+    s->lock->unlock(s->lock);
+    return node;
+}
+
+percpu_node_t *percpu_drain(percpu_t *pc, int cpu) {
+    percpu_slot_t *s = &pc->slots[cpu];
+    if (s->lock) lock(s->lock);
+    percpu_node_t *list = s->head;
+    s->head = NULL;
+    if (s->lock) s->lock->unlock(s->lock);
+    return list;
+}
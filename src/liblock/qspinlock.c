@@ -0,0 +1,180 @@
+#define _GNU_SOURCE
+#include "qspinlock.h"
+#include "percpu.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // For _mm_pause
+#endif
+
+#define CACHE_LINE 64
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__)
+#define CPU_RELAX() __asm__ __volatile__ ("yield" ::: "memory")
+#else
+#define CPU_RELAX() sched_yield()
+#endif
+
+// Spins briefly, then yields, so a preempted holder or predecessor gets to run.
+static inline void qspin_backoff(unsigned int *spins) {
+    if (*spins < QSPIN_SPINS) {
+        ++*spins;
+        CPU_RELAX();
+    } else {
+        sched_yield();
+    }
+}
+
+// --- Per-Thread Queue Nodes ---
+// Nodes live in one table so a tail encoded in the lock word can be decoded into a
+// node without any lookup. The table is allocated on first contention and never
+// freed, since a tail may still name a row after its thread has exited.
+typedef struct __attribute__((aligned(CACHE_LINE))) qspin_node_s {
+    struct qspin_node_s *next;
+    int locked; // Set to 1 by the predecessor when this node reaches the head of the queue
+} qspin_node_t;
+
+static qspin_node_t (*qspin_nodes)[QSPIN_MAX_NESTING] = NULL;
+static int qspin_nr_slots = 0; // Rows in qspin_nodes, a multiple of 64
+static _Atomic uint64_t qspin_slot_map[QSPIN_MAX_THREADS / 64];
+
+static _Thread_local int qspin_slot_c = -1;
+static _Thread_local int qspin_depth_c = 0;
+static pthread_key_t qspin_slot_key;
+static pthread_once_t qspin_slot_once = PTHREAD_ONCE_INIT;
+
+static void qspin_release_slot(void *value) {
+    int slot = (int) (intptr_t) value - 1;
+    atomic_fetch_and_explicit(&qspin_slot_map[slot / 64], ~(1ull << (slot % 64)), memory_order_release);
+}
+
+static void qspin_init_slots(void) {
+    pthread_key_create(&qspin_slot_key, qspin_release_slot);
+    long cpus = percpu_possible_cpus();
+    if (cpus <= 0) cpus = sysconf(_SC_NPROCESSORS_CONF);
+    if (cpus <= 0) cpus = 1;
+    long slots = (cpus * QSPIN_SLOTS_PER_CPU + 63) / 64 * 64;
+    if (slots > QSPIN_MAX_THREADS) slots = QSPIN_MAX_THREADS;
+    qspin_nodes = aligned_alloc(CACHE_LINE, sizeof(*qspin_nodes) * (size_t) slots);
+    // Without a table every contender waits on the word.
+    if (qspin_nodes) qspin_nr_slots = (int) slots;
+}
+
+// Claims a row of the node table for this thread; returns -1 if all rows are taken.
+static int qspin_thread_slot(void) {
+    if (__builtin_expect(qspin_slot_c >= 0, 1)) return qspin_slot_c;
+    pthread_once(&qspin_slot_once, qspin_init_slots);
+    for (int word = 0; word < qspin_nr_slots / 64; ++word) {
+        uint64_t bits = atomic_load_explicit(&qspin_slot_map[word], memory_order_relaxed);
+        while (~bits) {
+            int bit = __builtin_ctzll(~bits);
+            bits = atomic_fetch_or_explicit(&qspin_slot_map[word], 1ull << bit, memory_order_acquire);
+            if (!(bits & (1ull << bit))) {
+                qspin_slot_c = word * 64 + bit;
+                // Stored as slot + 1 so the destructor runs (it skips NULL values).
+                pthread_setspecific(qspin_slot_key, (void *) (intptr_t) (qspin_slot_c + 1));
+                return qspin_slot_c;
+            }
+        }
+    }
+    return -1;
+}
+
+static inline uint32_t qspin_encode_tail(int slot, int idx) {
+    return ((uint32_t) (slot + 1) << QSPIN_TAIL_SLOT_SHIFT) | ((uint32_t) idx << QSPIN_TAIL_IDX_SHIFT);
+}
+
+static inline qspin_node_t *qspin_decode_tail(uint32_t tail) {
+    int slot = (int) (tail >> QSPIN_TAIL_SLOT_SHIFT) - 1;
+    int idx = (int) ((tail >> QSPIN_TAIL_IDX_SHIFT) & (QSPIN_MAX_NESTING - 1));
+    return &qspin_nodes[slot][idx];
+}
+
+static inline uint32_t qspin_load(qspinlock_t *lock, int order) {
+    return __atomic_load_n(&lock->val, order);
+}
+
+// Publishes our tail while preserving the locked and pending bits; returns the old word.
+static inline uint32_t qspin_xchg_tail(qspinlock_t *lock, uint32_t tail) {
+    uint32_t old = qspin_load(lock, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&lock->val, &old, (old & ~QSPIN_TAIL_MASK) | tail, true,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+    }
+    return old;
+}
+
+// --- Slow Path ---
+void qspin_lock_slowpath(qspinlock_t *lock, uint32_t val) {
+    // A pending waiter is being handed the lock right now; give it a moment to finish.
+    if (val == QSPIN_PENDING_VAL) {
+        for (int i = 0; i < 512 && (val = qspin_load(lock, __ATOMIC_RELAXED)) == QSPIN_PENDING_VAL; ++i) {
+            CPU_RELAX();
+        }
+    }
+
+    unsigned int spins = 0;
+    // With only a holder present, become the single pending waiter and spin on the word.
+    if (!(val & ~QSPIN_LOCKED_MASK)) {
+        val = __atomic_fetch_or(&lock->val, QSPIN_PENDING_VAL, __ATOMIC_ACQUIRE);
+        if (!(val & ~QSPIN_LOCKED_MASK)) {
+            while (qspin_load(lock, __ATOMIC_ACQUIRE) & QSPIN_LOCKED_MASK) qspin_backoff(&spins);
+            // Nobody else may touch locked or pending while we own pending: take the lock.
+            __atomic_fetch_add(&lock->val, QSPIN_LOCKED_VAL - QSPIN_PENDING_VAL, __ATOMIC_ACQUIRE);
+            return;
+        }
+        // Someone else got pending or queued first; undo our bit if we were the one to set it.
+        if (!(val & QSPIN_PENDING_VAL)) __atomic_fetch_and(&lock->val, ~QSPIN_PENDING_VAL, __ATOMIC_RELAXED);
+    }
+
+    int slot = qspin_thread_slot();
+    int idx = qspin_depth_c;
+    if (slot < 0 || idx >= QSPIN_MAX_NESTING) {
+        // No queue node available (table exhausted, or a signal handler contending while this
+        // thread already waits in QSPIN_MAX_NESTING slow paths): wait on the word.
+        while (!qspin_trylock(lock)) qspin_backoff(&spins);
+        return;
+    }
+    qspin_depth_c = idx + 1;
+
+    qspin_node_t *node = &qspin_nodes[slot][idx];
+    node->next = NULL;
+    __atomic_store_n(&node->locked, 0, __ATOMIC_RELAXED);
+    uint32_t tail = qspin_encode_tail(slot, idx);
+
+    if (qspin_trylock(lock)) goto release;
+
+    uint32_t old = qspin_xchg_tail(lock, tail);
+    if (old & QSPIN_TAIL_MASK) {
+        qspin_node_t *prev = qspin_decode_tail(old);
+        __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+        while (!__atomic_load_n(&node->locked, __ATOMIC_ACQUIRE)) qspin_backoff(&spins);
+    }
+
+    // Head of the queue: wait for both the holder and any pending waiter to go away. If we
+    // are still the tail, the queue empties as we take the lock; a failed CAS here can be a
+    // contender briefly setting and clearing pending, so re-check rather than assume a successor.
+    for (;;) {
+        while ((val = qspin_load(lock, __ATOMIC_ACQUIRE)) & (QSPIN_LOCKED_MASK | QSPIN_PENDING_VAL)) qspin_backoff(&spins);
+        if ((val & QSPIN_TAIL_MASK) != tail) break;
+        if (__atomic_compare_exchange_n(&lock->val, &val, QSPIN_LOCKED_VAL, false, __ATOMIC_ACQUIRE,
+                                        __ATOMIC_RELAXED)) {
+            goto release;
+        }
+    }
+
+    // Waiters are queued behind us. Only the head may set the locked byte while the tail
+    // is non-zero, since the fast path CAS expects a zero word.
+    __atomic_fetch_or(&lock->val, QSPIN_LOCKED_VAL, __ATOMIC_ACQUIRE);
+    qspin_node_t *next;
+    while (!(next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE))) qspin_backoff(&spins);
+    __atomic_store_n(&next->locked, 1, __ATOMIC_RELEASE);
+
+release:
+    qspin_depth_c = idx;
+}
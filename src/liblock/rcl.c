@@ -0,0 +1,209 @@
+#define _GNU_SOURCE
+#include "rcl.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // For _mm_pause
+#endif
+
+#define CACHE_LINE 64
+#define RCL_CLIENT_SPINS 128 // Pauses before a waiting client starts yielding its CPU
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__)
+#define CPU_RELAX() __asm__ __volatile__ ("yield" ::: "memory")
+#else
+#define CPU_RELAX() sched_yield() // Fallback for other architectures
+#endif
+
+// --- Mailboxes ---
+// One per client slot and server. Only the owning client writes a request and only the
+// server completes it, so the line moves exactly twice per critical section.
+typedef struct __attribute__((aligned(CACHE_LINE))) {
+    _Atomic int posted; // 1 from the client's post until the server has stored the result
+    rcl_fn_t fn;
+    void *arg;
+    void *result;
+} rcl_mailbox_t;
+
+struct rcl_server_s {
+    rcl_mailbox_t mailboxes[RCL_MAX_CLIENTS];
+    pthread_t thread;
+    rcl_idle_t idle;
+    _Atomic int stop;
+    // 1 while the server is asleep or about to be; also its futex word.
+    __attribute__((aligned(CACHE_LINE))) _Atomic unsigned int parked;
+};
+
+// --- Client Slots ---
+// A thread uses the same slot on every server; slots are returned when the thread exits.
+static _Atomic uint64_t rcl_slot_map[RCL_MAX_CLIENTS / 64];
+static _Atomic int rcl_slots_hi = 0; // One past the highest slot ever claimed; servers scan below it
+
+static _Thread_local int rcl_slot_c = -1;
+static _Thread_local rcl_server_t *rcl_serving_c = NULL; // Set on server threads
+static pthread_key_t rcl_slot_key;
+static pthread_once_t rcl_slot_once = PTHREAD_ONCE_INIT;
+
+static void rcl_release_slot(void *value) {
+    int slot = (int) (intptr_t) value - 1;
+    atomic_fetch_and_explicit(&rcl_slot_map[slot / 64], ~(1ull << (slot % 64)), memory_order_release);
+}
+
+static void rcl_create_slot_key(void) {
+    pthread_key_create(&rcl_slot_key, rcl_release_slot);
+}
+
+static int rcl_try_claim_slot(void) {
+    for (int word = 0; word < RCL_MAX_CLIENTS / 64; ++word) {
+        uint64_t bits = atomic_load_explicit(&rcl_slot_map[word], memory_order_relaxed);
+        while (~bits) {
+            int bit = __builtin_ctzll(~bits);
+            bits = atomic_fetch_or_explicit(&rcl_slot_map[word], 1ull << bit, memory_order_acquire);
+            if (!(bits & (1ull << bit))) return word * 64 + bit;
+        }
+    }
+    return -1;
+}
+
+static int rcl_thread_slot(void) {
+    if (__builtin_expect(rcl_slot_c >= 0, 1)) return rcl_slot_c;
+    pthread_once(&rcl_slot_once, rcl_create_slot_key);
+    int slot;
+    while ((slot = rcl_try_claim_slot()) < 0) sched_yield(); // Every slot is held by a live thread
+    int hi = atomic_load_explicit(&rcl_slots_hi, memory_order_relaxed);
+    // seq_cst so a server about to park cannot scan below this slot after missing our post.
+    while (hi <= slot && !atomic_compare_exchange_weak_explicit(&rcl_slots_hi, &hi, slot + 1,
+                                                                memory_order_seq_cst, memory_order_relaxed)) {
+    }
+    rcl_slot_c = slot;
+    // Stored as slot + 1 so the destructor runs (it skips NULL values).
+    pthread_setspecific(rcl_slot_key, (void *) (intptr_t) (slot + 1));
+    return slot;
+}
+
+// --- Server ---
+static inline void rcl_futex(_Atomic unsigned int *word, int op, unsigned int val) {
+    syscall(SYS_futex, word, op, val, NULL, NULL, 0);
+}
+
+// Runs every posted request once; returns how many there were.
+static int rcl_serve_pass(rcl_server_t *s) {
+    int served = 0;
+    int hi = atomic_load_explicit(&rcl_slots_hi, memory_order_acquire);
+    for (int i = 0; i < hi; ++i) {
+        rcl_mailbox_t *mb = &s->mailboxes[i];
+        if (!atomic_load_explicit(&mb->posted, memory_order_acquire)) continue;
+        mb->result = mb->fn(mb->arg);
+        atomic_store_explicit(&mb->posted, 0, memory_order_release);
+        ++served;
+    }
+    return served;
+}
+
+static int rcl_any_posted(rcl_server_t *s) {
+    int hi = atomic_load_explicit(&rcl_slots_hi, memory_order_seq_cst);
+    for (int i = 0; i < hi; ++i) {
+        if (atomic_load_explicit(&s->mailboxes[i].posted, memory_order_seq_cst)) return 1;
+    }
+    return 0;
+}
+
+static void *rcl_server_main(void *arg) {
+    rcl_server_t *s = arg;
+    rcl_serving_c = s;
+    int idle_passes = 0;
+    while (!atomic_load_explicit(&s->stop, memory_order_acquire)) {
+        if (rcl_serve_pass(s)) {
+            idle_passes = 0;
+            continue;
+        }
+        if (++idle_passes < RCL_IDLE_SCANS) {
+            CPU_RELAX();
+            continue;
+        }
+        if (s->idle == RCL_IDLE_POLL) {
+            sched_yield();
+            continue;
+        }
+        // Dekker handshake with rcl_execute(): either we see its post here, or it sees
+        // parked == 1 after posting and wakes us.
+        atomic_store_explicit(&s->parked, 1, memory_order_seq_cst);
+        if (!rcl_any_posted(s) && !atomic_load_explicit(&s->stop, memory_order_seq_cst)) {
+            rcl_futex(&s->parked, FUTEX_WAIT_PRIVATE, 1);
+        }
+        atomic_store_explicit(&s->parked, 0, memory_order_relaxed);
+        idle_passes = 0;
+    }
+    rcl_serve_pass(s); // Nothing should be pending, but never strand a client
+    return NULL;
+}
+
+static void rcl_wake(rcl_server_t *s) {
+    if (atomic_load_explicit(&s->parked, memory_order_seq_cst) &&
+        atomic_exchange_explicit(&s->parked, 0, memory_order_seq_cst)) {
+        rcl_futex(&s->parked, FUTEX_WAKE_PRIVATE, 1);
+    }
+}
+
+// --- Public API ---
+rcl_server_t *rcl_server_create(int cpu, rcl_idle_t idle) {
+    if (cpu >= CPU_SETSIZE) return NULL;
+    rcl_server_t *s = aligned_alloc(CACHE_LINE, sizeof(rcl_server_t));
+    if (!s) return NULL;
+    for (int i = 0; i < RCL_MAX_CLIENTS; ++i) {
+        atomic_init(&s->mailboxes[i].posted, 0);
+    }
+    s->idle = idle;
+    atomic_init(&s->stop, 0);
+    atomic_init(&s->parked, 0);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    }
+    int rc = pthread_create(&s->thread, &attr, rcl_server_main, s);
+    pthread_attr_destroy(&attr);
+    if (rc != 0) {
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+void rcl_server_destroy(rcl_server_t *server) {
+    if (!server) return;
+    atomic_store_explicit(&server->stop, 1, memory_order_seq_cst);
+    atomic_store_explicit(&server->parked, 0, memory_order_seq_cst);
+    rcl_futex(&server->parked, FUTEX_WAKE_PRIVATE, 1);
+    pthread_join(server->thread, NULL);
+    free(server);
+}
+
+void *rcl_execute(rcl_server_t *server, rcl_fn_t fn, void *arg) {
+    // Already serialized by this server: posting would wait on ourselves.
+    if (rcl_serving_c == server) return fn(arg);
+
+    rcl_mailbox_t *mb = &server->mailboxes[rcl_thread_slot()];
+    mb->fn = fn;
+    mb->arg = arg;
+    atomic_store_explicit(&mb->posted, 1, memory_order_seq_cst);
+    if (server->idle == RCL_IDLE_PARK) rcl_wake(server);
+
+    for (int spins = 0; atomic_load_explicit(&mb->posted, memory_order_acquire); ++spins) {
+        if (spins < RCL_CLIENT_SPINS) CPU_RELAX();
+        else sched_yield();
+    }
+    return mb->result;
+}
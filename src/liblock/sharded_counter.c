@@ -0,0 +1,125 @@
+#define _GNU_SOURCE
+#include "sharded_counter.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define CACHE_LINE 64
+
+typedef struct __attribute__((aligned(CACHE_LINE))) {
+    _Atomic int64_t value;
+} counter_shard_t;
+
+struct sharded_counter_s {
+    _Atomic int64_t central;
+    int64_t batch;
+    unsigned int mask; // Shard count - 1; the shard count is a power of two
+    pthread_mutex_t fold_lock; // Serializes folds with exact reads; folds are rare, so it may block
+    counter_shard_t *shards;
+};
+
+static _Thread_local unsigned int counter_cpu_c = 0;
+static _Thread_local unsigned int counter_adds_c = 0;
+
+// The shards are atomic, so a stale CPU only costs contention, never correctness.
+static inline unsigned int counter_cpu(void) {
+    if (__builtin_expect(counter_adds_c++ % SHARDED_COUNTER_CPU_REFRESH == 0, 0)) {
+        int cpu = sched_getcpu();
+        counter_cpu_c = cpu < 0 ? 0 : (unsigned int) cpu;
+    }
+    return counter_cpu_c;
+}
+
+static inline int64_t counter_abs(int64_t v) {
+    return v < 0 ? -v : v;
+}
+
+// Moves a shard's value into the central count. Exact reads hold the same lock, so they
+// never see the value in neither place.
+static void counter_fold(sharded_counter_t *c, counter_shard_t *shard) {
+    pthread_mutex_lock(&c->fold_lock);
+    int64_t v = atomic_exchange_explicit(&shard->value, 0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->central, v, memory_order_relaxed);
+    pthread_mutex_unlock(&c->fold_lock);
+}
+
+sharded_counter_t *sharded_counter_create(int64_t batch) {
+    long cpus = sysconf(_SC_NPROCESSORS_CONF);
+    unsigned int shards = 1;
+    while (shards < (unsigned int) (cpus > 0 ? cpus : 1) && shards < SHARDED_COUNTER_MAX_SHARDS) shards <<= 1;
+
+    sharded_counter_t *c = malloc(sizeof(sharded_counter_t));
+    counter_shard_t *slots = aligned_alloc(CACHE_LINE, sizeof(counter_shard_t) * shards);
+    if (!c || !slots) {
+        free(c);
+        free(slots);
+        return NULL;
+    }
+    for (unsigned int i = 0; i < shards; ++i) {
+        atomic_init(&slots[i].value, 0);
+    }
+    atomic_init(&c->central, 0);
+    c->batch = batch > 0 ? batch : 0;
+    c->mask = shards - 1;
+    pthread_mutex_init(&c->fold_lock, NULL);
+    c->shards = slots;
+    return c;
+}
+
+void sharded_counter_destroy(sharded_counter_t *counter) {
+    if (!counter) return;
+    pthread_mutex_destroy(&counter->fold_lock);
+    free(counter->shards);
+    free(counter);
+}
+
+void sharded_counter_add(sharded_counter_t *counter, int64_t delta) {
+    // Large deltas go straight to the central count so a slot never holds a whole batch between folds.
+    if (counter->batch && counter_abs(delta) >= counter->batch) {
+        pthread_mutex_lock(&counter->fold_lock);
+        atomic_fetch_add_explicit(&counter->central, delta, memory_order_relaxed);
+        pthread_mutex_unlock(&counter->fold_lock);
+        return;
+    }
+    counter_shard_t *shard = &counter->shards[counter_cpu() & counter->mask];
+    int64_t v = atomic_fetch_add_explicit(&shard->value, delta, memory_order_relaxed) + delta;
+    if (counter->batch && counter_abs(v) >= counter->batch) counter_fold(counter, shard);
+}
+
+// Central count plus every slot. Central first: a value folded during the scan can then be
+// missed, but never counted twice.
+static int64_t counter_sum(sharded_counter_t *counter) {
+    int64_t sum = atomic_load_explicit(&counter->central, memory_order_relaxed);
+    for (unsigned int i = 0; i <= counter->mask; ++i) {
+        sum += atomic_load_explicit(&counter->shards[i].value, memory_order_relaxed);
+    }
+    return sum;
+}
+
+int64_t sharded_counter_read(sharded_counter_t *counter) {
+    // Without folds everything lives in the slots, so there is no cheaper read than the scan.
+    if (!counter->batch) return counter_sum(counter);
+    return atomic_load_explicit(&counter->central, memory_order_relaxed);
+}
+
+int64_t sharded_counter_read_exact(sharded_counter_t *counter) {
+    pthread_mutex_lock(&counter->fold_lock);
+    int64_t sum = counter_sum(counter);
+    pthread_mutex_unlock(&counter->fold_lock);
+    return sum;
+}
+
+int sharded_counter_compare(sharded_counter_t *counter, int64_t rhs) {
+    if (counter->batch) {
+        // A slot is folded as soon as it reaches +/-batch, so the central count is within
+        // batch of the true value per slot.
+        int64_t slack = counter->batch * (int64_t) (counter->mask + 1);
+        int64_t approx = atomic_load_explicit(&counter->central, memory_order_relaxed);
+        if (approx > rhs + slack) return 1;
+        if (approx < rhs - slack) return -1;
+    }
+    int64_t exact = sharded_counter_read_exact(counter);
+    return (exact > rhs) - (exact < rhs);
+}
@@ -0,0 +1,58 @@
+#include "ByteLock.hpp"
+#include "ParkingLot.hpp"
+#include <thread>
+
+namespace {
+    constexpr std::intptr_t kHandoff = 1; // Park token: the lock was passed to the woken thread and is already held
+} // end anonymous namespace
+
+void ByteLock::lockSlow() {
+    int spins = 0;
+    for (;;) {
+        std::uint8_t state = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+        if (!(state & kHeld)) {
+            if (__atomic_compare_exchange_n(&_state, &state, static_cast<std::uint8_t>(state | kHeld), true,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return;
+            }
+            continue;
+        }
+        // Spin only while nobody is parked; after that, spinning just delays the holder.
+        if (!(state & kParked) && spins < kSpins) {
+            ++spins;
+            std::this_thread::yield();
+            continue;
+        }
+        if (!(state & kParked) &&
+            !__atomic_compare_exchange_n(&_state, &state, static_cast<std::uint8_t>(state | kParked), false,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            continue;
+        }
+        std::intptr_t token = 0;
+        const bool parked = ParkingLot::park(this, [this] {
+            return __atomic_load_n(&_state, __ATOMIC_RELAXED) == (kHeld | kParked);
+        }, &token);
+        if (parked && token == kHandoff) return; // Handed off: the unlocker left the held bit set for us
+    }
+}
+
+void ByteLock::unlockSlow() {
+    for (;;) {
+        std::uint8_t state = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+        if (state == kHeld) {
+            if (__atomic_compare_exchange_n(&_state, &state, 0, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) return;
+            continue;
+        }
+        // Runs under the bucket lock, so no thread can park on the lock between this store and the wake.
+        ParkingLot::unparkOne(this, [this](ParkingLot::UnparkResult result) -> std::intptr_t {
+            const std::uint8_t parked = result.mayHaveMoreThreads ? kParked : 0;
+            if (result.didUnparkThread && result.timeToBeFair) {
+                __atomic_store_n(&_state, static_cast<std::uint8_t>(kHeld | parked), __ATOMIC_RELAXED);
+                return kHandoff;
+            }
+            __atomic_store_n(&_state, parked, __ATOMIC_RELEASE);
+            return 0;
+        });
+        return;
+    }
+}
@@ -0,0 +1,215 @@
+#include "Epoch.hpp"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifdef __linux__
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if __cplusplus >= 201703L
+#define CACHE_ALIGN alignas(std::hardware_destructive_interference_size)
+#else
+#define CACHE_ALIGN alignas(64)
+#endif
+
+namespace {
+    // An object is retired in the epoch current at retire(). Readers that might see it
+    // entered no later than that epoch, and the global epoch only moves past e + 1 once all
+    // of them have exited, so the object is freed when the global epoch reaches e + 2.
+    constexpr std::uint64_t kGrace = 2;
+
+    struct Retired {
+        void *ptr;
+        Epoch::FreeFn free_fn;
+        std::uint64_t epoch;
+    };
+
+    struct CACHE_ALIGN EpochRecord {
+        // The epoch this thread observed, shifted left by one, with bit 0 set while it is
+        // inside a read-side section. 0 when quiescent.
+        std::atomic<std::uint64_t> state{0};
+        std::atomic<bool> in_use{true};
+        EpochRecord *next = nullptr; // Registry link; records are recycled, never freed
+    };
+
+    struct CACHE_ALIGN EpochClock {
+        std::atomic<std::uint64_t> epoch{1};
+    };
+
+    EpochClock g_clock;
+    std::atomic<EpochRecord *> g_registry{nullptr};
+
+    // Retired objects left behind by exited threads, freed by whichever thread reclaims next.
+    std::mutex g_orphans_mutex;
+    std::deque<Retired> g_orphans;
+
+    // True when expedited membarrier is available: the reclaimer then issues the full fence
+    // on the readers' behalf and enter() only needs a compiler barrier.
+    bool registerMembarrier() {
+#if defined(__linux__) && defined(__NR_membarrier)
+        return syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+#else
+        return false;
+#endif
+    }
+
+    const bool g_light_fence = registerMembarrier();
+
+    void heavyFence() {
+#if defined(__linux__) && defined(__NR_membarrier)
+        if (g_light_fence && syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0) == 0) return;
+#endif
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    // Frees the prefix of a FIFO of retired objects that is safe in epoch e.
+    std::vector<Retired> detachReady(std::deque<Retired> &list, std::uint64_t e) {
+        std::vector<Retired> ready;
+        while (!list.empty() && list.front().epoch + kGrace <= e) {
+            ready.push_back(list.front());
+            list.pop_front();
+        }
+        return ready;
+    }
+
+    void freeAll(const std::vector<Retired> &ready) {
+        for (const Retired &r : ready) r.free_fn(r.ptr);
+    }
+
+    // Per-thread state. Its destructor hands leftovers to other threads when the thread exits.
+    class ThreadState {
+    public:
+        ~ThreadState() { release(); }
+
+        EpochRecord *record() {
+            if (__builtin_expect(_rec != nullptr, 1)) return _rec;
+            return acquire();
+        }
+
+        void release() {
+            if (!_rec) return;
+            if (!_limbo.empty()) {
+                std::lock_guard<std::mutex> guard(g_orphans_mutex);
+                g_orphans.insert(g_orphans.end(), _limbo.begin(), _limbo.end());
+            }
+            _limbo.clear();
+            _rec->state.store(0, std::memory_order_release);
+            _rec->in_use.store(false, std::memory_order_release);
+            _rec = nullptr;
+            nesting = 0;
+            retired_since_reclaim = 0;
+        }
+
+        std::deque<Retired> &limbo() { return _limbo; } // Oldest first
+
+        unsigned int nesting = 0;
+        unsigned int retired_since_reclaim = 0;
+
+    private:
+        EpochRecord *acquire() {
+            EpochRecord *rec = g_registry.load(std::memory_order_acquire);
+            for (; rec; rec = rec->next) {
+                bool expected = false;
+                if (!rec->in_use.load(std::memory_order_relaxed) &&
+                    rec->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire,
+                                                        std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            if (!rec) {
+                rec = new EpochRecord;
+                rec->next = g_registry.load(std::memory_order_relaxed);
+                while (!g_registry.compare_exchange_weak(rec->next, rec, std::memory_order_release,
+                                                         std::memory_order_relaxed)) {
+                }
+            }
+            return _rec = rec;
+        }
+
+        EpochRecord *_rec = nullptr;
+        std::deque<Retired> _limbo;
+    };
+
+    thread_local ThreadState t_epoch;
+
+    // Moves the epoch forward if every thread inside a read-side section has observed the
+    // current one. Returns the epoch in force afterwards.
+    std::uint64_t tryAdvance() {
+        std::uint64_t e = g_clock.epoch.load(std::memory_order_acquire);
+        heavyFence();
+        for (EpochRecord *rec = g_registry.load(std::memory_order_acquire); rec; rec = rec->next) {
+            const std::uint64_t state = rec->state.load(std::memory_order_acquire);
+            if ((state & 1) && (state >> 1) != e) return e;
+        }
+        if (g_clock.epoch.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return e + 1;
+        }
+        return e;
+    }
+} // end anonymous namespace
+
+void Epoch::registerThread() {
+    t_epoch.record();
+}
+
+void Epoch::unregisterThread() {
+    t_epoch.release();
+}
+
+// --- Read-Side Sections ---
+void Epoch::enter() {
+    EpochRecord *rec = t_epoch.record();
+    if (t_epoch.nesting++ > 0) return;
+
+    // Acquire: if we observe an advance, we also observe every unlink that preceded it.
+    const std::uint64_t e = g_clock.epoch.load(std::memory_order_acquire);
+    rec->state.store((e << 1) | 1, std::memory_order_relaxed);
+    // The state store must be visible before any shared pointer is loaded.
+    if (g_light_fence) std::atomic_signal_fence(std::memory_order_seq_cst);
+    else std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void Epoch::exit() {
+    if (--t_epoch.nesting > 0) return;
+    t_epoch.record()->state.store(0, std::memory_order_release);
+}
+
+// --- Reclamation ---
+void Epoch::reclaim() {
+    const std::uint64_t e = tryAdvance();
+    freeAll(detachReady(t_epoch.limbo(), e));
+
+    std::unique_lock<std::mutex> guard(g_orphans_mutex, std::try_to_lock);
+    if (guard.owns_lock()) {
+        std::vector<Retired> ready = detachReady(g_orphans, e);
+        guard.unlock();
+        freeAll(ready);
+    }
+}
+
+void Epoch::retire(void *ptr, FreeFn free_fn) {
+    // Registering makes sure our leftovers are handed to other threads when we exit.
+    t_epoch.record();
+    // The caller's unlink must be visible before we read the epoch the object is tagged with.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    t_epoch.limbo().push_back({ptr, free_fn, g_clock.epoch.load(std::memory_order_relaxed)});
+
+    if (++t_epoch.retired_since_reclaim >= kReclaimEvery) {
+        t_epoch.retired_since_reclaim = 0;
+        reclaim();
+    }
+}
+
+void Epoch::barrier() {
+    while (!t_epoch.limbo().empty()) {
+        reclaim();
+        if (!t_epoch.limbo().empty()) std::this_thread::yield();
+    }
+}
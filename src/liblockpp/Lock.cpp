@@ -1,9 +1,19 @@
 #include "ILock.hpp"
+#include "QSpinLock.hpp"
 #include "lock_types.h"
 #include <mutex>
 #include <atomic>
 #include <thread>
 #include <stdexcept>
+#include <utility>
+#include <chrono>
+#include <cstdint>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 #ifdef __GNUC__
 #include <immintrin.h> // For _mm_pause on x86/x64
 #endif
@@ -79,6 +89,36 @@ namespace {
         CACHE_ALIGN std::atomic<unsigned int> _next_ticket;
     };
 
+    // Queue nodes for the MCS-style locks. A thread needs one for every such lock it holds or
+    // waits for at once, so a single thread_local node would be shared between locks. The first
+    // kMcsMaxNesting nodes come from a per-thread array; further ones spill to the heap.
+    constexpr unsigned int kMcsMaxNesting = 16;
+
+    template <typename Node>
+    class McsNodePool {
+    public:
+        Node *take() {
+            if (_busy != (1u << kMcsMaxNesting) - 1) {
+                const unsigned int idx = __builtin_ctz(~_busy);
+                _busy |= 1u << idx;
+                return &_nodes[idx];
+            }
+            return new Node;
+        }
+
+        void give(Node *node) {
+            if (node >= _nodes && node < _nodes + kMcsMaxNesting) {
+                _busy &= ~(1u << (node - _nodes));
+            } else {
+                delete node;
+            }
+        }
+
+    private:
+        Node _nodes[kMcsMaxNesting];
+        unsigned int _busy = 0; // Bit i marks _nodes[i] as in use
+    };
+
     // --- MCS Lock Implementation (Deadlock Corrected) ---
     struct CACHE_ALIGN mcs_qnode_cpp {
         std::atomic<mcs_qnode_cpp *> next = nullptr;
@@ -88,129 +128,579 @@ namespace {
     class MCSLock final : public ILock {
     public:
         void lock() override {
-            _node.next.store(nullptr, std::memory_order_relaxed);
-            _node.locked.store(true, std::memory_order_relaxed);
-            auto *const pred = _tail.exchange(&_node, std::memory_order_acq_rel);
+            mcs_qnode_cpp *node = _pool.take();
+            node->next.store(nullptr, std::memory_order_relaxed);
+            node->locked.store(true, std::memory_order_relaxed);
+            auto *const pred = _tail.exchange(node, std::memory_order_acq_rel);
             if (pred) {
                 // Ensure the pred->next store is visible before the current thread spins.
-                // release ensures visibility of _node's state to pred.
-                pred->next.store(&_node, std::memory_order_release);
-                while (_node.locked.load(std::memory_order_acquire)) {
+                // release ensures visibility of the node's state to pred.
+                pred->next.store(node, std::memory_order_release);
+                while (node->locked.load(std::memory_order_acquire)) {
                     cpu_relax(); // Use CPU-specific pause
                 }
             }
+            _holder = node;
         }
 
         void unlock() override {
-            mcs_qnode_cpp *succ = _node.next.load(std::memory_order_acquire);
+            mcs_qnode_cpp *me = _holder;
+            mcs_qnode_cpp *succ = me->next.load(std::memory_order_acquire);
 
             if (succ == nullptr) {
-                mcs_qnode_cpp *me = &_node;
+                mcs_qnode_cpp *expected = me;
                 // Try to swing tail to nullptr. If it fails, another thread has already
                 // put itself on the queue.
-                if (_tail.compare_exchange_strong(me, nullptr, std::memory_order_release, std::memory_order_relaxed)) {
+                if (_tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed)) {
+                    _pool.give(me);
                     return; // Successfully unlocked and no successor
                 }
                 // We lost the race to clear the tail, so a successor exists.
                 // Spin until that successor has updated our node's next pointer.
-                while ((succ = _node.next.load(std::memory_order_acquire)) == nullptr) {
+                while ((succ = me->next.load(std::memory_order_acquire)) == nullptr) {
                     cpu_relax(); // Use CPU-specific pause
                 }
             }
             // Hand off the lock to the successor
             succ->locked.store(false, std::memory_order_release);
+            _pool.give(me);
         }
 
         bool trylock() override {
-            return false; /* Not implemented */
+            mcs_qnode_cpp *node = _pool.take();
+            node->next.store(nullptr, std::memory_order_relaxed);
+            // Only an empty queue can be taken without waiting.
+            mcs_qnode_cpp *expected = nullptr;
+            if (_tail.compare_exchange_strong(expected, node, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                _holder = node;
+                return true;
+            }
+            _pool.give(node);
+            return false;
         }
 
     private:
         CACHE_ALIGN std::atomic<mcs_qnode_cpp *> _tail = nullptr;
-        CACHE_ALIGN thread_local static inline mcs_qnode_cpp _node;
+        mcs_qnode_cpp *_holder = nullptr; // Node enqueued by the current holder, only touched by it
+        thread_local static inline McsNodePool<mcs_qnode_cpp> _pool;
+    };
+
+    // --- Time-Published MCS Lock Implementation ---
+    // Waiters publish a heartbeat while they spin. The releaser hands the lock only to a
+    // waiter whose heartbeat is fresh and unlinks the ones that look preempted; those
+    // requeue when they next run. Waiters that see the holder's critical section run far
+    // past normal park on a futex rather than burning the holder's CPU time.
+    constexpr std::uint64_t kTpWaiterPatienceNs = 50000;
+    constexpr std::uint64_t kTpHolderPatienceNs = 200000;
+    constexpr unsigned int kTpHeartbeatSpins = 64;
+
+    inline std::uint64_t tp_now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    enum TpState : unsigned int {
+        kTpWaiting,
+        kTpParked, // Blocked in the kernel, must be woken after a grant or skip
+        kTpGranted,
+        kTpSkipped // Unlinked by the releaser while it looked preempted; must requeue
+    };
+
+    inline void tp_park(std::atomic<unsigned int> &state) {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<unsigned int *>(&state), FUTEX_WAIT_PRIVATE, kTpParked, nullptr, nullptr, 0);
+#else
+        (void) state;
+        std::this_thread::yield();
+#endif
+    }
+
+    inline void tp_unpark(std::atomic<unsigned int> &state) {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<unsigned int *>(&state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+        (void) state;
+#endif
+    }
+
+    struct CACHE_ALIGN tp_qnode_cpp {
+        std::atomic<tp_qnode_cpp *> next = nullptr;
+        std::atomic<unsigned int> state = kTpWaiting; // Also the futex word
+        std::atomic<std::uint64_t> heartbeat = 0;
+    };
+
+    class MCSTPLock final : public ILock {
+    public:
+        void lock() override {
+            tp_qnode_cpp *node;
+            for (;;) {
+                node = _pool.take();
+                node->next.store(nullptr, std::memory_order_relaxed);
+                node->state.store(kTpWaiting, std::memory_order_relaxed);
+                node->heartbeat.store(tp_now_ns(), std::memory_order_relaxed);
+                auto *const pred = _tail.exchange(node, std::memory_order_acq_rel);
+                if (!pred) break;
+                pred->next.store(node, std::memory_order_release);
+                if (wait(*node) == kTpGranted) break;
+                // Skipped: the releaser no longer references our node, so it is free to requeue.
+                _pool.give(node);
+            }
+            _cs_start.store(tp_now_ns(), std::memory_order_relaxed);
+            _holder = node;
+        }
+
+        void unlock() override {
+            tp_qnode_cpp *me = _holder;
+            tp_qnode_cpp *succ = me->next.load(std::memory_order_acquire);
+            if (succ == nullptr) {
+                tp_qnode_cpp *expected = me;
+                if (_tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed)) {
+                    _pool.give(me);
+                    return;
+                }
+                while ((succ = me->next.load(std::memory_order_acquire)) == nullptr) {
+                    cpu_relax();
+                }
+            }
+
+            const std::uint64_t now = tp_now_ns();
+            while (looksPreempted(*succ, now)) {
+                // Read the link before skipping: once skipped, succ may requeue and reset it.
+                tp_qnode_cpp *next = succ->next.load(std::memory_order_acquire);
+                if (next == nullptr) {
+                    tp_qnode_cpp *expected = succ;
+                    if (_tail.compare_exchange_strong(expected, nullptr, std::memory_order_release,
+                                                      std::memory_order_relaxed)) {
+                        // Every remaining waiter was skipped; the lock is now free.
+                        resolve(*succ, kTpSkipped);
+                        _pool.give(me);
+                        return;
+                    }
+                    while ((next = succ->next.load(std::memory_order_acquire)) == nullptr) {
+                        cpu_relax();
+                    }
+                }
+                resolve(*succ, kTpSkipped);
+                succ = next;
+            }
+            resolve(*succ, kTpGranted);
+            _pool.give(me);
+        }
+
+        bool trylock() override {
+            tp_qnode_cpp *node = _pool.take();
+            node->next.store(nullptr, std::memory_order_relaxed);
+            tp_qnode_cpp *expected = nullptr;
+            if (_tail.compare_exchange_strong(expected, node, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+                _cs_start.store(tp_now_ns(), std::memory_order_relaxed);
+                _holder = node;
+                return true;
+            }
+            _pool.give(node);
+            return false;
+        }
+
+    private:
+        unsigned int wait(tp_qnode_cpp &node) {
+            for (unsigned int spins = 0;; ++spins) {
+                const unsigned int state = node.state.load(std::memory_order_acquire);
+                if (state == kTpGranted || state == kTpSkipped) return state;
+                if (state == kTpParked) {
+                    tp_park(node.state);
+                    continue;
+                }
+                if (spins % kTpHeartbeatSpins == 0) {
+                    const std::uint64_t now = tp_now_ns();
+                    node.heartbeat.store(now, std::memory_order_relaxed);
+                    if (now - _cs_start.load(std::memory_order_relaxed) > kTpHolderPatienceNs) {
+                        // The holder looks preempted. A failed CAS means we were just granted or skipped.
+                        unsigned int expected = kTpWaiting;
+                        node.state.compare_exchange_strong(expected, kTpParked, std::memory_order_acq_rel,
+                                                           std::memory_order_acquire);
+                        continue;
+                    }
+                }
+                cpu_relax();
+            }
+        }
+
+        static bool looksPreempted(const tp_qnode_cpp &node, std::uint64_t now) {
+            // Parked waiters are blocked by choice and cheap to wake, never skip them.
+            return node.state.load(std::memory_order_relaxed) == kTpWaiting &&
+                   now - node.heartbeat.load(std::memory_order_relaxed) > kTpWaiterPatienceNs;
+        }
+
+        // The node may be reused as soon as the exchange lands, so the wake-up is
+        // decided from the exchanged value alone.
+        static void resolve(tp_qnode_cpp &node, unsigned int state) {
+            if (node.state.exchange(state, std::memory_order_acq_rel) == kTpParked) {
+                tp_unpark(node.state);
+            }
+        }
+
+        CACHE_ALIGN std::atomic<tp_qnode_cpp *> _tail = nullptr;
+        std::atomic<std::uint64_t> _cs_start = 0; // When the current holder acquired the lock
+        tp_qnode_cpp *_holder = nullptr; // Node enqueued by the current holder, only touched by it
+        thread_local static inline McsNodePool<tp_qnode_cpp> _pool;
     };
 
-    // --- CLH Lock Implementation (Allocation-Free) ---
+    // --- CLH Lock Implementation (Node Recycling) ---
     struct CACHE_ALIGN clh_qnode_cpp {
         std::atomic<bool> locked = false;
+        clh_qnode_cpp *next_free = nullptr;
     };
 
+    // Nodes of exited threads, kept for reuse rather than deleted: a trylock may still read a
+    // node it saw at the tail some time ago.
+    struct ClhOrphans {
+        std::mutex mutex;
+        clh_qnode_cpp *head = nullptr;
+    };
+
+    ClhOrphans &clh_orphans() {
+        static ClhOrphans orphans;
+        return orphans;
+    }
+
+    // CLH nodes migrate between threads: a thread that acquires the lock adopts its
+    // predecessor's node. Each thread keeps the nodes it currently owns here.
+    class ClhNodePool {
+    public:
+        ~ClhNodePool() {
+            if (!_head) return;
+            clh_qnode_cpp *last = _head;
+            while (last->next_free) last = last->next_free;
+            ClhOrphans &orphans = clh_orphans();
+            std::lock_guard<std::mutex> guard(orphans.mutex);
+            last->next_free = orphans.head;
+            orphans.head = _head;
+        }
+
+        // The pool only runs dry before a thread's first acquisition (each acquisition takes
+        // one node and adopts one), so the orphan mutex is off the hot path.
+        clh_qnode_cpp *take() {
+            if (_head) return std::exchange(_head, _head->next_free);
+            {
+                ClhOrphans &orphans = clh_orphans();
+                std::lock_guard<std::mutex> guard(orphans.mutex);
+                if (orphans.head) return std::exchange(orphans.head, orphans.head->next_free);
+            }
+            return new clh_qnode_cpp;
+        }
+
+        void give(clh_qnode_cpp *node) {
+            node->next_free = _head;
+            _head = node;
+        }
+
+    private:
+        clh_qnode_cpp *_head = nullptr;
+    };
+
+    // The tail word packs the tail node's address (low kClhPtrBits bits, enough for user space
+    // on x86-64 and AArch64) with a count of enqueues in the high bits. Nodes recycle between
+    // threads, so the count is what lets trylock notice that the released tail it checked was
+    // adopted and enqueued again before its CAS (ABA).
+    constexpr unsigned int kClhPtrBits = 48;
+    constexpr std::uint64_t kClhPtrMask = (std::uint64_t{1} << kClhPtrBits) - 1;
+
     class CLHLock final : public ILock {
     public:
-        void lock() override {
-            // Swap nodes. _my_node becomes the node for this acquire, _next_node becomes the one for the next acquire.
-            // This is a correct approach for the allocation-free CLH.
-            std::swap(_my_node_ptr, _next_node_ptr);
-            _my_node_ptr->locked.store(true, std::memory_order_relaxed); // Current node is now 'locked'
+        // The queue always holds one released node so waiters never see an empty tail.
+        CLHLock() : _tail(pack(0, new clh_qnode_cpp)) {
+        }
 
-            // Atomically set _tail to _my_node_ptr and get the previous tail (our predecessor)
-            clh_qnode_cpp *pred = _tail.exchange(_my_node_ptr, std::memory_order_acq_rel);
+        ~CLHLock() override {
+            // The lock owns whichever node is left at the tail once it is released.
+            delete node(_tail.load(std::memory_order_relaxed));
+        }
 
-            if (pred) {
-                // If there's a predecessor, spin until its 'locked' flag becomes false
-                while (pred->locked.load(std::memory_order_acquire)) {
-                    cpu_relax(); // Use CPU-specific pause
-                }
+        void lock() override {
+            clh_qnode_cpp *mine = _pool.take();
+            mine->locked.store(true, std::memory_order_relaxed);
+
+            // Swing _tail to our node and get the previous tail (our predecessor)
+            std::uint64_t tail = _tail.load(std::memory_order_relaxed);
+            while (!_tail.compare_exchange_weak(tail, pack(tail, mine), std::memory_order_acq_rel,
+                                                std::memory_order_relaxed)) {
             }
-            // If pred is nullptr, we are the first in the queue.
-            // If pred->locked is false, predecessor has released the lock.
+            clh_qnode_cpp *pred = node(tail);
+            while (pred->locked.load(std::memory_order_acquire)) {
+                cpu_relax(); // Use CPU-specific pause
+            }
+            // Nobody else references the predecessor's node any more; adopt it.
+            _pool.give(pred);
+            _holder = mine;
         }
 
         void unlock() override {
-            // Atomically set _my_node's locked flag to false, releasing the lock for the successor.
-            _my_node_ptr->locked.store(false, std::memory_order_release);
+            // Our successor spins on this node and will adopt it once it sees the release.
+            _holder->locked.store(false, std::memory_order_release);
         }
 
         bool trylock() override {
-            clh_qnode_cpp *expected_tail = _tail.load(std::memory_order_relaxed);
-
-            // Early exit: If the queue tail exists and it's locked, the lock is currently held.
-            // No need to try to enqueue. `acquire` ensures we see the latest 'locked' status.
-            if (expected_tail != nullptr && expected_tail->locked.load(std::memory_order_acquire)) {
-                return false; // Lock is busy
-            }
-
-            // If we reach here, the lock *appears* free (queue is empty, or tail is unlocked).
-            // Now, try to acquire it using a Compare-And-Swap (CAS).
-            // We use `_next_node_ptr` as the node this thread will attempt to use for this acquisition.
-            clh_qnode_cpp *node_for_attempt = _next_node_ptr;
-            // Optimistically set its 'locked' flag to true.
-            node_for_attempt->locked.store(true, std::memory_order_relaxed);
-
-            // Attempt to make our `node_for_attempt` the new tail.
-            // `expected_tail` is the value _tail *should* be right now for the CAS to succeed.
-            // If it matches, _tail is updated to `node_for_attempt`.
-            // If it doesn't match, another thread won the race, and `expected_tail` is updated to the actual current tail.
-            if (_tail.compare_exchange_strong(expected_tail, node_for_attempt,
+            std::uint64_t tail = _tail.load(std::memory_order_acquire);
+            clh_qnode_cpp *pred = node(tail);
+
+            // Early exit: the tail node is still locked, so the lock is held or queued on.
+            if (pred->locked.load(std::memory_order_acquire)) {
+                return false;
+            }
+
+            clh_qnode_cpp *mine = _pool.take();
+            mine->locked.store(true, std::memory_order_relaxed);
+            // Fails if anyone enqueued since we read the tail, even with a recycled node at the same address.
+            if (_tail.compare_exchange_strong(tail, pack(tail, mine),
                                               std::memory_order_acq_rel, std::memory_order_relaxed)) {
-                // CAS succeeded: We are now the tail. Lock acquired.
-                // Now, crucial for the allocation-free model:
-                // We successfully used `_next_node_ptr` to acquire the lock.
-                // So, we swap the roles of `_my_node_ptr` and `_next_node_ptr`.
-                // This makes `node_for_attempt` (which was `_next_node_ptr`) the new `_my_node_ptr`
-                // so that subsequent `unlock()` calls use the correct node.
-                // `_next_node_ptr` now points to the other `thread_local` node, ready for the next acquisition attempt.
-                std::swap(_my_node_ptr, _next_node_ptr);
-                return true; // Lock acquired
-            }
-            // CAS failed: Another thread beat us to setting the tail.
-            // We did not acquire the lock. Our `node_for_attempt` is NOT linked into the queue.
-            // No cleanup or undo is needed.
-            // The `_my_node_ptr` and `_next_node_ptr` remain in their original states from before this `trylock` call.
-            return false; // Lock not acquired
+                _pool.give(pred);
+                _holder = mine;
+                return true;
+            }
+            // Our node was never published, so it can go straight back to the pool.
+            _pool.give(mine);
+            return false;
         }
 
     private:
-        CACHE_ALIGN std::atomic<clh_qnode_cpp *> _tail = nullptr;
+        static clh_qnode_cpp *node(std::uint64_t tail) {
+            return reinterpret_cast<clh_qnode_cpp *>(static_cast<std::uintptr_t>(tail & kClhPtrMask));
+        }
+
+        // The word that makes n the tail after tail, one enqueue later.
+        static std::uint64_t pack(std::uint64_t tail, clh_qnode_cpp *n) {
+            return ((tail & ~kClhPtrMask) + (std::uint64_t{1} << kClhPtrBits)) |
+                   static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(n));
+        }
 
-        // Ensure nodes are aligned to cache lines to prevent false sharing.
-        // C++17 `std::hardware_destructive_interference_size` is preferred.
-        CACHE_ALIGN thread_local static inline clh_qnode_cpp _node_A;
-        CACHE_ALIGN thread_local static inline clh_qnode_cpp _node_B;
+        CACHE_ALIGN std::atomic<std::uint64_t> _tail;
+        // Node enqueued by the current holder; only the holder reads or writes it.
+        clh_qnode_cpp *_holder = nullptr;
+
+        thread_local static inline ClhNodePool _pool;
+    };
+    // --- Queued Spinlock Adapter ---
+    // QSpinLock is a four-byte value type meant for embedding; this exposes it through ILock.
+    class QSpinILock final : public ILock {
+    public:
+        void lock() override { _lock.lock(); }
+        void unlock() override { _lock.unlock(); }
+        bool trylock() override { return _lock.trylock(); }
+
+    private:
+        QSpinLock _lock;
+    };
+
+    // --- Reentrant Wrapper ---
+    // Compact, never reused tag identifying the calling thread as a lock owner.
+    inline std::uint32_t current_owner_tag() {
+        static std::atomic<std::uint32_t> next_tag{1};
+        thread_local std::uint32_t tag = 0;
+        if (__builtin_expect(tag == 0, 0)) tag = next_tag.fetch_add(1, std::memory_order_relaxed);
+        return tag;
+    }
+
+    // Makes any of the locks above reentrant. Re-entry is recognized by comparing the owner
+    // tag with our own: only this thread ever stores its tag, so a relaxed load is enough and
+    // a nested acquire or release costs no atomic read-modify-write.
+    template <typename Base>
+    class RecursiveLock final : public ILock {
+    public:
+        void lock() override {
+            const std::uint32_t me = current_owner_tag();
+            if (_owner.load(std::memory_order_relaxed) == me) {
+                ++_depth;
+                return;
+            }
+            _base.lock();
+            _owner.store(me, std::memory_order_relaxed);
+            _depth = 1;
+        }
+
+        void unlock() override {
+            if (--_depth > 0) return;
+            _owner.store(0, std::memory_order_relaxed);
+            _base.unlock();
+        }
+
+        bool trylock() override {
+            const std::uint32_t me = current_owner_tag();
+            if (_owner.load(std::memory_order_relaxed) == me) {
+                ++_depth;
+                return true;
+            }
+            if (!_base.trylock()) return false;
+            _owner.store(me, std::memory_order_relaxed);
+            _depth = 1;
+            return true;
+        }
+
+    private:
+        Base _base;
+        std::atomic<std::uint32_t> _owner{0}; // 0 when free
+        std::uint32_t _depth = 0; // Only touched by the holder
+    };
+
+    // --- Biased Lock ---
+    // Consecutive acquisitions by one thread through the fallback lock after which a revoked
+    // biased lock is biased towards that thread again.
+    constexpr std::uint32_t kRebiasAfter = 1024;
+
+    // True when expedited membarrier is available: revokers then issue the full fence on the
+    // bias owner's behalf and the owner's fast path only needs a compiler barrier. Registered
+    // by the first BiasedLock, so processes that never create one make no syscall.
+    bool g_bias_light_fence = false;
+    std::once_flag g_bias_once;
+
+    void registerBiasMembarrier() {
+#if defined(__linux__) && defined(__NR_membarrier)
+        g_bias_light_fence = syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+#endif
+    }
+
+    // Non-template base so biasRevocations() can find the counter whatever the fallback lock is.
+    class BiasedLockBase : public ILock {
+    public:
+        std::uint64_t revocations() const { return _revocations.load(std::memory_order_relaxed); }
 
-        // Use _my_node_ptr and _next_node_ptr for clarity and consistency with the original code's intent
-        thread_local static inline clh_qnode_cpp *_my_node_ptr = &_node_A;
-        thread_local static inline clh_qnode_cpp *_next_node_ptr = &_node_B;
+    protected:
+        std::atomic<std::uint64_t> _revocations{0};
+    };
+
+    // The first thread to lock owns the bias and afterwards acquires by setting _in_cs and
+    // re-reading the bias word. Any other thread first takes the fallback lock, then revokes:
+    // it publishes kRevoked, issues a full fence on the owner's behalf and waits for _in_cs
+    // to drop. This is Dekker's handshake with an asymmetric fence.
+    template <typename Base>
+    class BiasedLock final : public BiasedLockBase {
+    public:
+        // Done at construction so every thread that later uses the lock agrees on the fence protocol.
+        BiasedLock() { std::call_once(g_bias_once, registerBiasMembarrier); }
+
+        void lock() override {
+            const std::uint32_t me = current_owner_tag();
+            // Re-entry would let the owner in twice through the fast path and corrupt the fallback lock.
+            if (_owner.load(std::memory_order_relaxed) == me) {
+                throw std::runtime_error("BiasedLock re-acquired by the thread that holds it.");
+            }
+            if (!tryFast(me)) {
+                _base.lock();
+                settle(me, true);
+            }
+            _owner.store(me, std::memory_order_relaxed);
+        }
+
+        void unlock() override {
+            _owner.store(0, std::memory_order_relaxed);
+            if (_fast_held) {
+                _fast_held = false;
+                _in_cs.store(0, std::memory_order_release);
+                return;
+            }
+            beforeRelease();
+            _base.unlock();
+        }
+
+        bool trylock() override {
+            const std::uint32_t me = current_owner_tag();
+            if (_owner.load(std::memory_order_relaxed) == me) return false;
+            if (!tryFast(me)) {
+                if (!_base.trylock()) return false;
+                if (!settle(me, false)) {
+                    // The bias owner is inside its critical section; it will take the fallback lock next time.
+                    _base.unlock();
+                    return false;
+                }
+            }
+            _owner.store(me, std::memory_order_relaxed);
+            return true;
+        }
+
+    private:
+        static constexpr std::uint64_t kUnbiased = 0;
+        static constexpr std::uint64_t kRevoked = 2;
+
+        static constexpr std::uint64_t biasedTowards(std::uint32_t tag) {
+            return (static_cast<std::uint64_t>(tag) << 2) | 1;
+        }
+
+        bool tryFast(std::uint32_t me) {
+            const std::uint64_t mine = biasedTowards(me);
+            std::uint64_t state = _state.load(std::memory_order_relaxed);
+            if (state != mine) {
+                // Only a lock nobody has used yet can be claimed outside the fallback lock.
+                if (state != kUnbiased ||
+                    !_state.compare_exchange_strong(state, mine, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    return false;
+                }
+            }
+            _in_cs.store(1, std::memory_order_relaxed);
+            if (g_bias_light_fence) std::atomic_signal_fence(std::memory_order_seq_cst);
+            else std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_state.load(std::memory_order_acquire) == mine) {
+                _fast_held = true;
+                return true;
+            }
+            // A revoker got in first and may be waiting for us.
+            _in_cs.store(0, std::memory_order_release);
+            return false;
+        }
+
+        // Called with the fallback lock held: makes sure no bias owner can enter through the fast path.
+        // Without wait, returns false instead of waiting for an owner that is inside its critical
+        // section; the revocation stays published, so the owner cannot enter again.
+        bool settle(std::uint32_t me, bool wait) {
+            std::uint64_t state = _state.load(std::memory_order_acquire);
+            while (state != kRevoked) {
+                if (state == biasedTowards(me)) {
+                    // We own the bias, so nobody else can be in the fast path.
+                    _fast_held = false;
+                    return true;
+                }
+                if (!_state.compare_exchange_weak(state, kRevoked, std::memory_order_seq_cst,
+                                                  std::memory_order_acquire)) {
+                    continue;
+                }
+#if defined(__linux__) && defined(__NR_membarrier)
+                if (!g_bias_light_fence || syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0) != 0)
+#endif
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (state != kUnbiased) _revocations.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            // Also checked when the lock was already revoked: a trylock that gave up here left the
+            // owner it revoked inside its critical section.
+            while (_in_cs.load(std::memory_order_acquire)) {
+                if (!wait) return false;
+                std::this_thread::yield();
+            }
+            _fast_held = false;
+            return true;
+        }
+
+        // Called with the fallback lock held, just before releasing it.
+        void beforeRelease() {
+            if (_state.load(std::memory_order_relaxed) != kRevoked) return;
+            const std::uint32_t me = current_owner_tag();
+            if (_streak_owner != me) {
+                _streak_owner = me;
+                _streak = 0;
+            }
+            if (++_streak >= kRebiasAfter) {
+                // Nobody else has needed the lock for a while. Threads queued for the fallback
+                // lock behind us will find the new bias in settle() and revoke it again.
+                _streak = 0;
+                _state.store(biasedTowards(me), std::memory_order_release);
+            }
+        }
+
+        Base _base;
+        CACHE_ALIGN std::atomic<std::uint64_t> _state{kUnbiased};
+        std::atomic<std::uint32_t> _in_cs{0}; // Set by the bias owner while it holds the lock through the fast path
+        bool _fast_held = false; // The current holder took the fast path, only touched by it
+        std::atomic<std::uint32_t> _owner{0}; // Tag of the holding thread, 0 when free
+        std::uint32_t _streak_owner = 0; // Protected by the fallback lock
+        std::uint32_t _streak = 0;
     };
 } // end anonymous namespace
 
@@ -221,6 +711,18 @@ std::unique_ptr<ILock> createLock(lock_type_t type) {
         case LOCK_TYPE_TICKET: return std::make_unique<TicketLock>();
         case LOCK_TYPE_MCS: return std::make_unique<MCSLock>();
         case LOCK_TYPE_CLH: return std::make_unique<CLHLock>();
+        case LOCK_TYPE_MCS_TP: return std::make_unique<MCSTPLock>();
+        case LOCK_TYPE_QSPINLOCK: return std::make_unique<QSpinILock>();
+        case LOCK_TYPE_RECURSIVE_TICKET: return std::make_unique<RecursiveLock<TicketLock> >();
+        case LOCK_TYPE_RECURSIVE_MCS: return std::make_unique<RecursiveLock<MCSLock> >();
+        case LOCK_TYPE_RECURSIVE_CLH: return std::make_unique<RecursiveLock<CLHLock> >();
+        case LOCK_TYPE_BIASED_TICKET: return std::make_unique<BiasedLock<TicketLock> >();
+        case LOCK_TYPE_BIASED_MCS: return std::make_unique<BiasedLock<MCSLock> >();
         default: throw std::runtime_error("Unknown lock type requested.");
     }
 }
+
+std::uint64_t biasRevocations(const ILock &lock) {
+    const auto *biased = dynamic_cast<const BiasedLockBase *>(&lock);
+    return biased ? biased->revocations() : 0;
+}
@@ -0,0 +1,178 @@
+#include "ParkingLot.hpp"
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <thread>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#ifdef __GNUC__
+#include <immintrin.h> // For _mm_pause on x86/x64
+#endif
+
+#if __cplusplus >= 201703L
+#define CACHE_ALIGN alignas(std::hardware_destructive_interference_size)
+#else
+#define CACHE_ALIGN alignas(64)
+#endif
+
+namespace {
+    constexpr int kBucketLockSpins = 64; // Pauses before a thread waiting for a bucket yields its CPU
+
+    inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__ ("yield" ::: "memory");
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    // A parked thread's record lives on its own stack for as long as it is parked.
+    struct Waiter {
+        const void *addr = nullptr;
+        Waiter *next = nullptr;
+        std::intptr_t token = 0;
+        std::atomic<unsigned int> woken{0}; // Futex word; set once the waiter has been dequeued
+
+        void wait() {
+            while (!woken.load(std::memory_order_acquire)) {
+#ifdef __linux__
+                syscall(SYS_futex, reinterpret_cast<unsigned int *>(&woken), FUTEX_WAIT_PRIVATE, 0, nullptr, nullptr, 0);
+#else
+                std::this_thread::yield();
+#endif
+            }
+        }
+
+        void wake(std::intptr_t value) {
+            token = value;
+            woken.store(1, std::memory_order_release);
+            // This record may already be gone; a stray wake on its old stack slot is harmless to futex users.
+#ifdef __linux__
+            syscall(SYS_futex, reinterpret_cast<unsigned int *>(&woken), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+        }
+    };
+
+    struct CACHE_ALIGN Bucket {
+        std::atomic<bool> locked{false}; // Held only while the queue is inspected or changed
+        Waiter *head = nullptr;
+        Waiter *tail = nullptr;
+        std::uint64_t next_fair_ns = 0;
+
+        void lock() {
+            for (int spins = 0; locked.exchange(true, std::memory_order_acquire); ++spins) {
+                while (locked.load(std::memory_order_relaxed)) {
+                    if (spins++ < kBucketLockSpins) cpu_relax();
+                    else std::this_thread::yield();
+                }
+            }
+        }
+
+        void unlock() { locked.store(false, std::memory_order_release); }
+
+        void unlink(Waiter *prev, Waiter *w) {
+            if (prev) prev->next = w->next;
+            else head = w->next;
+            if (tail == w) tail = prev;
+        }
+    };
+
+    Bucket g_buckets[ParkingLot::kBuckets];
+
+    inline Bucket &bucket_for(const void *addr) {
+        const std::uint64_t h = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(addr)) * 0x9E3779B97F4A7C15ull;
+        return g_buckets[(h >> 32) % ParkingLot::kBuckets];
+    }
+
+    inline std::uint64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+} // end anonymous namespace
+
+bool ParkingLot::parkImpl(const void *addr, ValidateFn validate, void *ctx, std::intptr_t *token) {
+    Waiter me;
+    me.addr = addr;
+
+    Bucket &b = bucket_for(addr);
+    b.lock();
+    if (validate && !validate(ctx)) {
+        b.unlock();
+        return false;
+    }
+    if (b.tail) b.tail->next = &me;
+    else b.head = &me;
+    b.tail = &me;
+    b.unlock();
+
+    me.wait();
+    if (token) *token = me.token;
+    return true;
+}
+
+ParkingLot::UnparkResult ParkingLot::unparkOneImpl(const void *addr, CallbackFn callback, void *ctx) {
+    UnparkResult result;
+    Bucket &b = bucket_for(addr);
+    b.lock();
+
+    Waiter *prev = nullptr, *w = b.head;
+    while (w && w->addr != addr) {
+        prev = w;
+        w = w->next;
+    }
+    if (w) {
+        b.unlink(prev, w);
+        result.didUnparkThread = true;
+        for (Waiter *rest = w->next; rest; rest = rest->next) {
+            if (rest->addr == addr) {
+                result.mayHaveMoreThreads = true;
+                break;
+            }
+        }
+        // Randomize the interval so locks sharing a bucket do not turn fair in lockstep.
+        const std::uint64_t now = now_ns();
+        if (now >= b.next_fair_ns) {
+            result.timeToBeFair = true;
+            b.next_fair_ns = now + ((now * 0x9E3779B97F4A7C15ull) >> 40) % (2 * kFairIntervalNs);
+        }
+    }
+    const std::intptr_t token = callback ? callback(result, ctx) : 0;
+    b.unlock();
+
+    if (w) w->wake(token);
+    return result;
+}
+
+unsigned ParkingLot::unparkAll(const void *addr) {
+    Bucket &b = bucket_for(addr);
+    Waiter *woken = nullptr, **woken_tail = &woken;
+    b.lock();
+    Waiter *prev = nullptr, *w = b.head;
+    while (w) {
+        Waiter *next = w->next;
+        if (w->addr == addr) {
+            b.unlink(prev, w);
+            w->next = nullptr;
+            *woken_tail = w;
+            woken_tail = &w->next;
+        } else {
+            prev = w;
+        }
+        w = next;
+    }
+    b.unlock();
+
+    unsigned count = 0;
+    while (woken) {
+        Waiter *next = woken->next; // Read before waking: the record dies with the park
+        woken->wake(0);
+        woken = next;
+        ++count;
+    }
+    return count;
+}
@@ -0,0 +1,228 @@
+#include "QSpinLock.hpp"
+#include <atomic>
+#include <new>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#ifdef __GNUC__
+#include <immintrin.h> // For _mm_pause on x86/x64
+#endif
+
+#if __cplusplus >= 201703L
+#define CACHE_ALIGN alignas(std::hardware_destructive_interference_size)
+#else
+#define CACHE_ALIGN alignas(64)
+#endif
+
+namespace {
+    // Word layout:
+    //   bits  0-7   locked byte
+    //   bit   8     pending (a single waiter spinning on the word itself)
+    //   bits 16-17  tail nesting index
+    //   bits 18-31  tail thread slot + 1
+    constexpr std::uint32_t kLockedVal = 1u;
+    constexpr std::uint32_t kLockedMask = 0xffu;
+    constexpr std::uint32_t kPendingVal = 1u << 8;
+    constexpr int kTailIdxShift = 16;
+    constexpr int kTailIdxBits = 2;
+    constexpr int kTailSlotShift = kTailIdxShift + kTailIdxBits;
+    constexpr std::uint32_t kTailMask = ~0u << kTailIdxShift;
+    // Nodes per row. A node is only held while its thread waits in the slow path, so this
+    // bounds slow-path waits nested inside one another (a signal handler that contends while
+    // its thread is queued), not how many locks a thread holds.
+    constexpr int kMaxNesting = 1 << kTailIdxBits;
+    constexpr int kMaxThreads = 4096;  // Upper bound on node table rows
+    constexpr int kSlotsPerCpu = 4;    // Node table rows per possible CPU
+    constexpr unsigned kSpins = 64;    // Pause iterations before a waiter starts yielding
+
+    inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__ ("yield" ::: "memory");
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    // Spins briefly, then yields, so a preempted holder or predecessor gets to run.
+    class Backoff {
+    public:
+        void pause() {
+            if (_spins < kSpins) {
+                ++_spins;
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+    private:
+        unsigned _spins = 0;
+    };
+
+    struct CACHE_ALIGN qspin_node_cpp {
+        qspin_node_cpp *next = nullptr;
+        int locked = 0; // Set to 1 by the predecessor when this node reaches the head of the queue
+    };
+
+    struct qspin_row_cpp {
+        qspin_node_cpp nodes[kMaxNesting];
+    };
+
+    // One more than the highest possible CPU id (the mask looks like "0-3,8-11"), or -1.
+    int possible_cpus() {
+        std::FILE *f = std::fopen("/sys/devices/system/cpu/possible", "re");
+        if (!f) return -1;
+        long last = -1, lo, hi;
+        char sep;
+        while (std::fscanf(f, "%ld", &lo) == 1) {
+            hi = lo;
+            if (std::fscanf(f, "%c", &sep) == 1 && sep == '-' && std::fscanf(f, "%ld", &hi) == 1) {
+                if (std::fscanf(f, "%c", &sep) != 1) sep = '\n';
+            }
+            if (hi > last) last = hi;
+            if (sep != ',') break;
+        }
+        std::fclose(f);
+        return last < 0 ? -1 : static_cast<int>(last) + 1;
+    }
+
+    // Nodes live in one table so a tail encoded in the lock word can be decoded into a
+    // node without any lookup. The table is allocated on first contention and never
+    // freed, since a tail may still name a row after its thread has exited.
+    qspin_row_cpp *g_nodes = nullptr;
+    int g_slots = 0; // Rows in g_nodes, a multiple of 64
+    std::once_flag g_nodes_once;
+    std::atomic<std::uint64_t> g_slot_map[kMaxThreads / 64];
+
+    void allocate_nodes() {
+        long cpus = possible_cpus();
+        if (cpus <= 0) cpus = std::thread::hardware_concurrency();
+        if (cpus <= 0) cpus = 1;
+        long slots = (cpus * kSlotsPerCpu + 63) / 64 * 64;
+        if (slots > kMaxThreads) slots = kMaxThreads;
+        // Without a table every contender waits on the word.
+        g_nodes = new (std::nothrow) qspin_row_cpp[slots];
+        if (g_nodes) g_slots = static_cast<int>(slots);
+    }
+
+    // Owns this thread's row of the node table and returns it when the thread exits.
+    class SlotLease {
+    public:
+        ~SlotLease() {
+            if (_slot >= 0) {
+                g_slot_map[_slot / 64].fetch_and(~(1ull << (_slot % 64)), std::memory_order_release);
+            }
+        }
+
+        int slot() {
+            if (__builtin_expect(_slot >= 0, 1)) return _slot;
+            std::call_once(g_nodes_once, allocate_nodes);
+            for (int word = 0; word < g_slots / 64; ++word) {
+                std::uint64_t bits = g_slot_map[word].load(std::memory_order_relaxed);
+                while (~bits) {
+                    const int bit = __builtin_ctzll(~bits);
+                    bits = g_slot_map[word].fetch_or(1ull << bit, std::memory_order_acquire);
+                    if (!(bits & (1ull << bit))) return _slot = word * 64 + bit;
+                }
+            }
+            return -1;
+        }
+
+        int depth = 0;
+
+    private:
+        int _slot = -1;
+    };
+
+    thread_local SlotLease t_lease;
+
+    inline std::uint32_t encode_tail(int slot, int idx) {
+        return (static_cast<std::uint32_t>(slot + 1) << kTailSlotShift) |
+               (static_cast<std::uint32_t>(idx) << kTailIdxShift);
+    }
+
+    inline qspin_node_cpp *decode_tail(std::uint32_t tail) {
+        const int slot = static_cast<int>(tail >> kTailSlotShift) - 1;
+        const int idx = static_cast<int>((tail >> kTailIdxShift) & (kMaxNesting - 1));
+        return &g_nodes[slot].nodes[idx];
+    }
+
+    inline bool try_lock_word(std::uint32_t *word) {
+        std::uint32_t expected = __atomic_load_n(word, __ATOMIC_RELAXED);
+        if (expected != 0) return false;
+        return __atomic_compare_exchange_n(word, &expected, kLockedVal, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    }
+} // end anonymous namespace
+
+void QSpinLock::lockSlow(std::uint32_t val) {
+    // A pending waiter is being handed the lock right now; give it a moment to finish.
+    if (val == kPendingVal) {
+        for (int i = 0; i < 512 && (val = __atomic_load_n(&_val, __ATOMIC_RELAXED)) == kPendingVal; ++i) {
+            cpu_relax();
+        }
+    }
+
+    Backoff backoff;
+    // With only a holder present, become the single pending waiter and spin on the word.
+    if (!(val & ~kLockedMask)) {
+        val = __atomic_fetch_or(&_val, kPendingVal, __ATOMIC_ACQUIRE);
+        if (!(val & ~kLockedMask)) {
+            while (__atomic_load_n(&_val, __ATOMIC_ACQUIRE) & kLockedMask) backoff.pause();
+            // Nobody else may touch locked or pending while we own pending: take the lock.
+            __atomic_fetch_add(&_val, kLockedVal - kPendingVal, __ATOMIC_ACQUIRE);
+            return;
+        }
+        // Someone else got pending or queued first; undo our bit if we were the one to set it.
+        if (!(val & kPendingVal)) __atomic_fetch_and(&_val, ~kPendingVal, __ATOMIC_RELAXED);
+    }
+
+    const int slot = t_lease.slot();
+    const int idx = t_lease.depth;
+    if (slot < 0 || idx >= kMaxNesting) {
+        // No queue node available (table exhausted, or a signal handler contending while this
+        // thread already waits in kMaxNesting slow paths): wait on the word.
+        while (!try_lock_word(&_val)) backoff.pause();
+        return;
+    }
+    t_lease.depth = idx + 1;
+
+    qspin_node_cpp *node = &g_nodes[slot].nodes[idx];
+    node->next = nullptr;
+    __atomic_store_n(&node->locked, 0, __ATOMIC_RELAXED);
+    const std::uint32_t tail = encode_tail(slot, idx);
+
+    if (!try_lock_word(&_val)) {
+        // Publish our tail while preserving the locked and pending bits.
+        std::uint32_t old = __atomic_load_n(&_val, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&_val, &old, (old & ~kTailMask) | tail, true,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        }
+        if (old & kTailMask) {
+            __atomic_store_n(&decode_tail(old)->next, node, __ATOMIC_RELEASE);
+            while (!__atomic_load_n(&node->locked, __ATOMIC_ACQUIRE)) backoff.pause();
+        }
+
+        // Head of the queue: wait for both the holder and any pending waiter to go away. If we
+        // are still the tail, the queue empties as we take the lock; a failed CAS here can be a
+        // contender briefly setting and clearing pending, so re-check rather than assume a successor.
+        bool sole_waiter = false;
+        while (!sole_waiter) {
+            while ((val = __atomic_load_n(&_val, __ATOMIC_ACQUIRE)) & (kLockedMask | kPendingVal)) backoff.pause();
+            if ((val & kTailMask) != tail) break;
+            sole_waiter = __atomic_compare_exchange_n(&_val, &val, kLockedVal, false, __ATOMIC_ACQUIRE,
+                                                      __ATOMIC_RELAXED);
+        }
+        if (!sole_waiter) {
+            // Waiters are queued behind us. Only the head may set the locked byte while the
+            // tail is non-zero, since the fast path CAS expects a zero word.
+            __atomic_fetch_or(&_val, kLockedVal, __ATOMIC_ACQUIRE);
+            qspin_node_cpp *next;
+            while ((next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)) == nullptr) backoff.pause();
+            __atomic_store_n(&next->locked, 1, __ATOMIC_RELEASE);
+        }
+    }
+    t_lease.depth = idx;
+}
@@ -0,0 +1,233 @@
+#include "RemoteCore.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <pthread.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#ifdef __GNUC__
+#include <immintrin.h> // For _mm_pause on x86/x64
+#endif
+
+#if __cplusplus >= 201703L
+#define CACHE_ALIGN alignas(std::hardware_destructive_interference_size)
+#else
+#define CACHE_ALIGN alignas(64)
+#endif
+
+namespace {
+    constexpr int kClientSpins = 128; // Pauses before a waiting client starts yielding its CPU
+
+    inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__ ("yield" ::: "memory");
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    inline void futex_wait(std::atomic<unsigned int> &word, unsigned int val) {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<unsigned int *>(&word), FUTEX_WAIT_PRIVATE, val, nullptr, nullptr, 0);
+#else
+        (void) word;
+        (void) val;
+        std::this_thread::yield();
+#endif
+    }
+
+    inline void futex_wake(std::atomic<unsigned int> &word) {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<unsigned int *>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+        (void) word;
+#endif
+    }
+
+    // --- Client Slots ---
+    // A thread uses the same slot on every server; slots are returned when the thread exits.
+    constexpr int kMaxClients = RemoteCoreServer::kMaxClients;
+    std::atomic<std::uint64_t> g_slot_map[kMaxClients / 64];
+    std::atomic<int> g_slots_hi{0}; // One past the highest slot ever claimed; servers scan below it
+
+    class SlotLease {
+    public:
+        ~SlotLease() {
+            if (_slot >= 0) {
+                g_slot_map[_slot / 64].fetch_and(~(1ull << (_slot % 64)), std::memory_order_release);
+            }
+        }
+
+        int slot() {
+            if (__builtin_expect(_slot >= 0, 1)) return _slot;
+            int slot;
+            while ((slot = tryClaim()) < 0) std::this_thread::yield(); // Every slot is held by a live thread
+            // seq_cst so a server about to park cannot scan below this slot after missing our post.
+            int hi = g_slots_hi.load(std::memory_order_relaxed);
+            while (hi <= slot && !g_slots_hi.compare_exchange_weak(hi, slot + 1, std::memory_order_seq_cst,
+                                                                   std::memory_order_relaxed)) {
+            }
+            return _slot = slot;
+        }
+
+    private:
+        static int tryClaim() {
+            for (int word = 0; word < kMaxClients / 64; ++word) {
+                std::uint64_t bits = g_slot_map[word].load(std::memory_order_relaxed);
+                while (~bits) {
+                    const int bit = __builtin_ctzll(~bits);
+                    bits = g_slot_map[word].fetch_or(1ull << bit, std::memory_order_acquire);
+                    if (!(bits & (1ull << bit))) return word * 64 + bit;
+                }
+            }
+            return -1;
+        }
+
+        int _slot = -1;
+    };
+
+    thread_local SlotLease t_lease;
+    thread_local const void *t_serving = nullptr; // Set on server threads
+} // end anonymous namespace
+
+// --- Server ---
+// One mailbox per client slot. Only the owning client writes a request and only the
+// server completes it, so the line moves exactly twice per critical section.
+struct RemoteCoreServer::Impl {
+    struct CACHE_ALIGN Mailbox {
+        std::atomic<int> posted{0}; // 1 from the client's post until the server has run it
+        Thunk thunk = nullptr;
+        void *call = nullptr;
+    };
+
+    Mailbox mailboxes[kMaxClients];
+    Idle idle;
+    std::atomic<bool> stop{false};
+    // 1 while the server is asleep or about to be; also its futex word.
+    CACHE_ALIGN std::atomic<unsigned int> parked{0};
+    pthread_t thread;
+
+    explicit Impl(Idle policy) : idle(policy) {}
+
+    static void *serverMain(void *arg) {
+        static_cast<Impl *>(arg)->run();
+        return nullptr;
+    }
+
+    // Runs every posted request once; returns how many there were.
+    int servePass() {
+        int served = 0;
+        const int hi = g_slots_hi.load(std::memory_order_acquire);
+        for (int i = 0; i < hi; ++i) {
+            Mailbox &mb = mailboxes[i];
+            if (!mb.posted.load(std::memory_order_acquire)) continue;
+            mb.thunk(mb.call);
+            mb.posted.store(0, std::memory_order_release);
+            ++served;
+        }
+        return served;
+    }
+
+    bool anyPosted() {
+        const int hi = g_slots_hi.load(std::memory_order_seq_cst);
+        for (int i = 0; i < hi; ++i) {
+            if (mailboxes[i].posted.load(std::memory_order_seq_cst)) return true;
+        }
+        return false;
+    }
+
+    void run() {
+        t_serving = this;
+        int idle_passes = 0;
+        while (!stop.load(std::memory_order_acquire)) {
+            if (servePass()) {
+                idle_passes = 0;
+                continue;
+            }
+            if (++idle_passes < kIdleScans) {
+                cpu_relax();
+                continue;
+            }
+            if (idle == Idle::Poll) {
+                std::this_thread::yield();
+                continue;
+            }
+            // Dekker handshake with post(): either we see its request here, or it sees
+            // parked == 1 after posting and wakes us.
+            parked.store(1, std::memory_order_seq_cst);
+            if (!anyPosted() && !stop.load(std::memory_order_seq_cst)) futex_wait(parked, 1);
+            parked.store(0, std::memory_order_relaxed);
+            idle_passes = 0;
+        }
+        servePass(); // Nothing should be pending, but never strand a client
+    }
+
+    void wake() {
+        if (parked.load(std::memory_order_seq_cst) && parked.exchange(0, std::memory_order_seq_cst)) {
+            futex_wake(parked);
+        }
+    }
+
+    void shutdown() {
+        stop.store(true, std::memory_order_seq_cst);
+        parked.store(0, std::memory_order_seq_cst);
+        futex_wake(parked);
+        pthread_join(thread, nullptr);
+    }
+};
+
+RemoteCoreServer::RemoteCoreServer(int cpu, Idle idle) : _impl(std::make_unique<Impl>(idle)) {
+    // The affinity goes on the attributes, so the server never runs a pass off its CPU.
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+#ifdef __linux__
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        if (cpu >= CPU_SETSIZE || pthread_attr_setaffinity_np(&attr, sizeof(set), &set) != 0) {
+            pthread_attr_destroy(&attr);
+            throw std::runtime_error("Cannot pin the remote core server to the requested CPU.");
+        }
+    }
+#else
+    (void) cpu;
+#endif
+    const int rc = pthread_create(&_impl->thread, &attr, &Impl::serverMain, _impl.get());
+    pthread_attr_destroy(&attr);
+    // EINVAL here means the requested CPU is offline or outside the allowed set.
+    if (rc == EINVAL && cpu >= 0) throw std::runtime_error("Cannot pin the remote core server to the requested CPU.");
+    if (rc != 0) throw std::runtime_error("Cannot start the remote core server thread.");
+}
+
+RemoteCoreServer::~RemoteCoreServer() {
+    _impl->shutdown();
+}
+
+void RemoteCoreServer::post(Thunk thunk, void *call) {
+    // Already serialized by this server: posting would wait on ourselves.
+    if (t_serving == _impl.get()) {
+        thunk(call);
+        return;
+    }
+
+    Impl::Mailbox &mb = _impl->mailboxes[t_lease.slot()];
+    mb.thunk = thunk;
+    mb.call = call;
+    mb.posted.store(1, std::memory_order_seq_cst);
+    if (_impl->idle == Idle::Park) _impl->wake();
+
+    for (int spins = 0; mb.posted.load(std::memory_order_acquire); ++spins) {
+        if (spins < kClientSpins) cpu_relax();
+        else std::this_thread::yield();
+    }
+}
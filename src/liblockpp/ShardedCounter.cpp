@@ -0,0 +1,114 @@
+#include "ShardedCounter.hpp"
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <thread>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#if __cplusplus >= 201703L
+#define CACHE_ALIGN alignas(std::hardware_destructive_interference_size)
+#else
+#define CACHE_ALIGN alignas(64)
+#endif
+
+namespace {
+    struct CACHE_ALIGN Shard {
+        std::atomic<std::int64_t> value{0};
+    };
+
+    thread_local unsigned int t_cpu = 0;
+    thread_local unsigned int t_adds = 0;
+
+    // The shards are atomic, so a stale CPU only costs contention, never correctness.
+    inline unsigned int current_cpu() {
+        if (__builtin_expect(t_adds++ % ShardedCounter::kCpuRefresh == 0, 0)) {
+#ifdef __linux__
+            const int cpu = sched_getcpu();
+            t_cpu = cpu < 0 ? 0 : static_cast<unsigned int>(cpu);
+#endif
+        }
+        return t_cpu;
+    }
+
+    inline std::int64_t abs64(std::int64_t v) {
+        return v < 0 ? -v : v;
+    }
+
+    unsigned int shard_count() {
+        const unsigned int cpus = std::thread::hardware_concurrency();
+        unsigned int shards = 1;
+        while (shards < (cpus ? cpus : 1) && shards < ShardedCounter::kMaxShards) shards <<= 1;
+        return shards;
+    }
+} // end anonymous namespace
+
+struct ShardedCounter::Impl {
+    explicit Impl(std::int64_t b)
+        : batch(b > 0 ? b : 0), mask(shard_count() - 1), shards(std::make_unique<Shard[]>(mask + 1)) {}
+
+    // Moves a shard's value into the central count. Exact reads hold the same lock, so they
+    // never see the value in neither place.
+    void fold(Shard &shard) {
+        std::lock_guard<std::mutex> guard(fold_lock);
+        central.fetch_add(shard.value.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    // Central count plus every slot.
+    std::int64_t sum() const {
+        // Central first: a value folded during the scan can then be missed, but never counted twice.
+        std::int64_t total = central.load(std::memory_order_relaxed);
+        for (unsigned int i = 0; i <= mask; ++i) total += shards[i].value.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    std::atomic<std::int64_t> central{0};
+    const std::int64_t batch;
+    const unsigned int mask; // Shard count - 1; the shard count is a power of two
+    std::mutex fold_lock;    // Serializes folds with exact reads; folds are rare, so it may block
+    std::unique_ptr<Shard[]> shards;
+};
+
+ShardedCounter::ShardedCounter(std::int64_t batch) : _impl(std::make_unique<Impl>(batch)) {}
+
+ShardedCounter::~ShardedCounter() = default;
+
+void ShardedCounter::add(std::int64_t delta) {
+    Impl &c = *_impl;
+    // Large deltas go straight to the central count so a slot never holds a whole batch between folds.
+    if (c.batch && abs64(delta) >= c.batch) {
+        std::lock_guard<std::mutex> guard(c.fold_lock);
+        c.central.fetch_add(delta, std::memory_order_relaxed);
+        return;
+    }
+    Shard &shard = c.shards[current_cpu() & c.mask];
+    const std::int64_t v = shard.value.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (c.batch && abs64(v) >= c.batch) c.fold(shard);
+}
+
+std::int64_t ShardedCounter::read() const {
+    const Impl &c = *_impl;
+    // Without folds everything lives in the slots, so there is no cheaper read than the scan.
+    if (!c.batch) return c.sum();
+    return c.central.load(std::memory_order_relaxed);
+}
+
+std::int64_t ShardedCounter::readExact() const {
+    std::lock_guard<std::mutex> guard(_impl->fold_lock);
+    return _impl->sum();
+}
+
+int ShardedCounter::compare(std::int64_t rhs) const {
+    const Impl &c = *_impl;
+    if (c.batch) {
+        // A slot is folded as soon as it reaches +/-batch, so the central count is within
+        // batch of the true value per slot.
+        const std::int64_t slack = c.batch * static_cast<std::int64_t>(c.mask + 1);
+        const std::int64_t approx = c.central.load(std::memory_order_relaxed);
+        if (approx > rhs + slack) return 1;
+        if (approx < rhs - slack) return -1;
+    }
+    const std::int64_t exact = readExact();
+    return (exact > rhs) - (exact < rhs);
+}
@@ -0,0 +1,433 @@
+#define _GNU_SOURCE
+#include "lock.h"
+#include <dlfcn.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+// LD_PRELOAD shim that backs pthread mutexes with liblock algorithms.
+//
+//   LIBLOCK_TYPE=mcs LD_PRELOAD=liblock_preload.so ./service
+//
+// Every default-kind pthread_mutex_t is mapped to a lock_t through a side table
+// that is filled lazily on first use, so PTHREAD_MUTEX_INITIALIZER mutexes work
+// without an init call. Recursive, error-checking, robust and process-shared
+// mutexes are passed through to the real implementation untouched. The kind comes
+// from the attribute given to pthread_mutex_init, or from the static initializer.
+//
+// Condition variables are reimplemented on futexes so they can wait on any
+// mutex, interposed or not. Process-shared ones use shared futex operations.
+
+#define CACHE_LINE 64
+#define SIDE_TABLE_BUCKETS 4096
+
+// --- Real pthread Entry Points ---
+typedef int (*mutex_init_fn)(pthread_mutex_t *, const pthread_mutexattr_t *);
+typedef int (*mutex_fn)(pthread_mutex_t *);
+typedef int (*mutex_timed_fn)(pthread_mutex_t *, const struct timespec *);
+typedef int (*mutex_clock_fn)(pthread_mutex_t *, clockid_t, const struct timespec *);
+
+static mutex_init_fn real_mutex_init;
+static mutex_fn real_mutex_destroy;
+static mutex_fn real_mutex_lock;
+static mutex_fn real_mutex_trylock;
+static mutex_fn real_mutex_unlock;
+static mutex_timed_fn real_mutex_timedlock;
+static mutex_clock_fn real_mutex_clocklock;
+
+static lock_type_t preload_lock_type = LOCK_TYPE_MCS;
+static bool preload_passthrough = false;
+static pthread_once_t preload_once = PTHREAD_ONCE_INIT;
+
+static void preload_init(void) {
+    real_mutex_init = (mutex_init_fn) dlsym(RTLD_NEXT, "pthread_mutex_init");
+    real_mutex_destroy = (mutex_fn) dlsym(RTLD_NEXT, "pthread_mutex_destroy");
+    real_mutex_lock = (mutex_fn) dlsym(RTLD_NEXT, "pthread_mutex_lock");
+    real_mutex_trylock = (mutex_fn) dlsym(RTLD_NEXT, "pthread_mutex_trylock");
+    real_mutex_unlock = (mutex_fn) dlsym(RTLD_NEXT, "pthread_mutex_unlock");
+    real_mutex_timedlock = (mutex_timed_fn) dlsym(RTLD_NEXT, "pthread_mutex_timedlock");
+    real_mutex_clocklock = (mutex_clock_fn) dlsym(RTLD_NEXT, "pthread_mutex_clocklock");
+
+    const char *name = getenv("LIBLOCK_TYPE");
+    if (!name || !*name) return;
+    if (!strcasecmp(name, "mutex") || !strcasecmp(name, "pthread")) preload_lock_type = LOCK_TYPE_PTHREAD_MUTEX;
+    else if (!strcasecmp(name, "ticket")) preload_lock_type = LOCK_TYPE_TICKET;
+    else if (!strcasecmp(name, "mcs")) preload_lock_type = LOCK_TYPE_MCS;
+    else if (!strcasecmp(name, "clh")) preload_lock_type = LOCK_TYPE_CLH;
+    else if (!strcasecmp(name, "mcs-tp")) preload_lock_type = LOCK_TYPE_MCS_TP;
+    else if (!strcasecmp(name, "qspinlock")) preload_lock_type = LOCK_TYPE_QSPINLOCK;
+    else {
+        fprintf(stderr, "liblock_preload: unknown LIBLOCK_TYPE '%s', using pthread mutexes.\n", name);
+        preload_lock_type = LOCK_TYPE_PTHREAD_MUTEX;
+    }
+    // A pthread-backed lock_t would call straight back into this shim.
+    preload_passthrough = (preload_lock_type == LOCK_TYPE_PTHREAD_MUTEX);
+}
+
+__attribute__((constructor)) static void preload_constructor(void) {
+    pthread_once(&preload_once, preload_init);
+}
+
+static inline void ensure_init(void) {
+    if (__builtin_expect(real_mutex_lock == NULL, 0)) pthread_once(&preload_once, preload_init);
+}
+
+// --- Side Table: pthread_mutex_t* -> lock_t* ---
+// Lookups are lock-free. Insertions and removals take a per-bucket spin flag.
+// Entries are never freed, only recycled, so a lookup can always dereference
+// whatever it finds in a chain.
+typedef struct mutex_entry_s {
+    _Atomic(pthread_mutex_t *) key;
+    lock_t *lock; // NULL for mutexes passed through to the real implementation
+    struct mutex_entry_s *_Atomic next;
+} mutex_entry_t;
+
+typedef struct __attribute__((aligned(CACHE_LINE))) {
+    _Atomic(mutex_entry_t *) head;
+    atomic_flag busy;
+} side_bucket_t;
+
+static side_bucket_t side_table[SIDE_TABLE_BUCKETS];
+
+static inline side_bucket_t *bucket_for(const pthread_mutex_t *m) {
+    uintptr_t h = (uintptr_t) m;
+    h ^= h >> 17;
+    h *= 0x9E3779B97F4A7C15ull;
+    return &side_table[(h >> 32) % SIDE_TABLE_BUCKETS];
+}
+
+static inline void bucket_acquire(side_bucket_t *b) {
+    while (atomic_flag_test_and_set_explicit(&b->busy, memory_order_acquire)) sched_yield();
+}
+
+static inline void bucket_release(side_bucket_t *b) {
+    atomic_flag_clear_explicit(&b->busy, memory_order_release);
+}
+
+static inline mutex_entry_t *find_entry(side_bucket_t *b, const pthread_mutex_t *m) {
+    for (mutex_entry_t *e = atomic_load_explicit(&b->head, memory_order_acquire); e;
+         e = atomic_load_explicit(&e->next, memory_order_acquire)) {
+        if (atomic_load_explicit(&e->key, memory_order_acquire) == m) return e;
+    }
+    return NULL;
+}
+
+// Only mutexes of the default kind can be swapped for a liblock algorithm. pthread_mutex_init
+// records the kind from its attribute.
+static bool attr_is_plain(const pthread_mutexattr_t *attr) {
+    if (!attr) return true;
+    int type, pshared, robust, protocol;
+    if (pthread_mutexattr_gettype(attr, &type) != 0) return false;
+    if (type != PTHREAD_MUTEX_NORMAL && type != PTHREAD_MUTEX_DEFAULT) return false;
+    if (pthread_mutexattr_getpshared(attr, &pshared) != 0 || pshared != PTHREAD_PROCESS_PRIVATE) return false;
+    if (pthread_mutexattr_getrobust(attr, &robust) != 0 || robust != PTHREAD_MUTEX_STALLED) return false;
+    return pthread_mutexattr_getprotocol(attr, &protocol) == 0 && protocol == PTHREAD_PRIO_NONE;
+}
+
+// A mutex first seen without an init call still holds its static initializer, since the
+// real implementation has never touched it. Only PTHREAD_MUTEX_INITIALIZER (or zeroed
+// memory) denotes the default kind; the recursive and error-checking initializers differ.
+static bool is_default_initializer(const pthread_mutex_t *m) {
+    static const pthread_mutex_t initializer = PTHREAD_MUTEX_INITIALIZER;
+    return memcmp(m, &initializer, sizeof(*m)) == 0;
+}
+
+// Maps m, replacing any existing entry. Called with the bucket held.
+static mutex_entry_t *insert_entry(side_bucket_t *b, pthread_mutex_t *m, bool plain) {
+    mutex_entry_t *e = find_entry(b, m);
+    if (e) {
+        destroy_lock_object(e->lock);
+        e->lock = plain ? create_lock_object(preload_lock_type) : NULL;
+        return e;
+    }
+    // Recycle a retired entry in this chain before growing it.
+    for (mutex_entry_t *it = atomic_load_explicit(&b->head, memory_order_relaxed); it;
+         it = atomic_load_explicit(&it->next, memory_order_relaxed)) {
+        if (atomic_load_explicit(&it->key, memory_order_relaxed) == NULL) {
+            e = it;
+            break;
+        }
+    }
+    bool fresh = (e == NULL);
+    if (fresh) {
+        e = calloc(1, sizeof(mutex_entry_t));
+        if (!e) return NULL;
+    }
+    e->lock = plain ? create_lock_object(preload_lock_type) : NULL;
+    atomic_store_explicit(&e->key, m, memory_order_release);
+    if (fresh) {
+        atomic_store_explicit(&e->next, atomic_load_explicit(&b->head, memory_order_relaxed),
+                              memory_order_relaxed);
+        atomic_store_explicit(&b->head, e, memory_order_release);
+    }
+    return e;
+}
+
+static mutex_entry_t *lookup_or_create(pthread_mutex_t *m) {
+    side_bucket_t *b = bucket_for(m);
+    mutex_entry_t *e = find_entry(b, m);
+    if (__builtin_expect(e != NULL, 1)) return e;
+
+    bucket_acquire(b);
+    e = find_entry(b, m);
+    if (!e) e = insert_entry(b, m, is_default_initializer(m));
+    bucket_release(b);
+    return e;
+}
+
+static void map_mutex(pthread_mutex_t *m, bool plain) {
+    side_bucket_t *b = bucket_for(m);
+    bucket_acquire(b);
+    insert_entry(b, m, plain);
+    bucket_release(b);
+}
+
+static void forget_mutex(pthread_mutex_t *m) {
+    side_bucket_t *b = bucket_for(m);
+    bucket_acquire(b);
+    mutex_entry_t *e = find_entry(b, m);
+    if (e) {
+        atomic_store_explicit(&e->key, NULL, memory_order_release);
+        destroy_lock_object(e->lock);
+        e->lock = NULL;
+    }
+    bucket_release(b);
+}
+
+static inline bool timespec_reached(clockid_t clock, const struct timespec *deadline) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return now.tv_sec > deadline->tv_sec ||
+           (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
+}
+
+// --- Interposed Mutex API ---
+int pthread_mutex_init(pthread_mutex_t *m, const pthread_mutexattr_t *attr) {
+    ensure_init();
+    int rc = real_mutex_init(m, attr);
+    // The address may be reused without an intervening destroy, so the mapping is replaced.
+    if (rc == 0 && !preload_passthrough) map_mutex(m, attr_is_plain(attr));
+    return rc;
+}
+
+int pthread_mutex_destroy(pthread_mutex_t *m) {
+    ensure_init();
+    if (!preload_passthrough) forget_mutex(m);
+    return real_mutex_destroy(m);
+}
+
+int pthread_mutex_lock(pthread_mutex_t *m) {
+    ensure_init();
+    if (preload_passthrough) return real_mutex_lock(m);
+    mutex_entry_t *e = lookup_or_create(m);
+    if (!e || !e->lock) return real_mutex_lock(m);
+    lock(e->lock);
+    return 0;
+}
+
+int pthread_mutex_trylock(pthread_mutex_t *m) {
+    ensure_init();
+    if (preload_passthrough) return real_mutex_trylock(m);
+    mutex_entry_t *e = lookup_or_create(m);
+    if (!e || !e->lock) return real_mutex_trylock(m);
+    return trylock(e->lock) ? 0 : EBUSY;
+}
+
+static int clocklock_impl(pthread_mutex_t *m, clockid_t clock, const struct timespec *abstime) {
+    mutex_entry_t *e = lookup_or_create(m);
+    if (!e || !e->lock) {
+        if (clock == CLOCK_REALTIME || !real_mutex_clocklock) return real_mutex_timedlock(m, abstime);
+        return real_mutex_clocklock(m, clock, abstime);
+    }
+    // liblock has no timed acquire; poll trylock until the deadline passes.
+    while (!trylock(e->lock)) {
+        if (timespec_reached(clock, abstime)) return ETIMEDOUT;
+        sched_yield();
+    }
+    return 0;
+}
+
+int pthread_mutex_timedlock(pthread_mutex_t *m, const struct timespec *abstime) {
+    ensure_init();
+    if (preload_passthrough) return real_mutex_timedlock(m, abstime);
+    return clocklock_impl(m, CLOCK_REALTIME, abstime);
+}
+
+int pthread_mutex_clocklock(pthread_mutex_t *m, clockid_t clock, const struct timespec *abstime) {
+    ensure_init();
+    if (preload_passthrough) return real_mutex_clocklock(m, clock, abstime);
+    return clocklock_impl(m, clock, abstime);
+}
+
+int pthread_mutex_unlock(pthread_mutex_t *m) {
+    ensure_init();
+    if (preload_passthrough) return real_mutex_unlock(m);
+    mutex_entry_t *e = find_entry(bucket_for(m), m);
+    if (!e || !e->lock) return real_mutex_unlock(m);
+    e->lock->unlock(e->lock);
+    return 0;
+}
+
+// --- Interposed Condition Variable API ---
+// A private condvar keeps a FIFO queue of waiters in the storage of pthread_cond_t. Each
+// waiter sleeps on a futex word in its own stack frame, and signal dequeues the oldest, so
+// a signal always goes to a thread that was already waiting when it was sent. A static
+// PTHREAD_COND_INITIALIZER is all zeros, which is an empty queue.
+//
+// A process-shared condvar cannot link stack frames of different processes. It waits on a
+// sequence word with shared futex operations instead, and signal wakes every waiter, so a
+// later waiter can never take the only wakeup. POSIX permits the spurious wakeups this adds.
+typedef struct cond_waiter_s {
+    struct cond_waiter_s *prev;
+    struct cond_waiter_s *next;
+    _Atomic unsigned int signaled; // Futex word; set once the waiter is dequeued by a signal
+} cond_waiter_t;
+
+typedef struct {
+    cond_waiter_t *head; // Oldest waiter; private condvars only
+    cond_waiter_t *tail;
+    _Atomic unsigned int busy; // Spin flag guarding the queue
+    _Atomic unsigned int seq;  // Process-shared condvars only
+    clockid_t clock;
+    int pshared;
+} cond_state_t;
+
+_Static_assert(sizeof(cond_state_t) <= sizeof(pthread_cond_t), "cond_state_t must fit in pthread_cond_t");
+
+static inline long futex(_Atomic unsigned int *uaddr, int op, unsigned int val, const struct timespec *ts,
+                         unsigned int val3) {
+    return syscall(SYS_futex, uaddr, op, val, ts, NULL, val3);
+}
+
+static inline void cond_queue_acquire(cond_state_t *cs) {
+    while (atomic_exchange_explicit(&cs->busy, 1, memory_order_acquire)) sched_yield();
+}
+
+static inline void cond_queue_release(cond_state_t *cs) {
+    atomic_store_explicit(&cs->busy, 0, memory_order_release);
+}
+
+static inline void cond_unlink(cond_state_t *cs, cond_waiter_t *w) {
+    if (w->prev) w->prev->next = w->next;
+    else cs->head = w->next;
+    if (w->next) w->next->prev = w->prev;
+    else cs->tail = w->prev;
+}
+
+// Dequeues and wakes the oldest waiter; called with the queue held. The waiter takes the
+// queue before it returns, so its frame outlives the wake.
+static bool cond_wake_oldest(cond_state_t *cs) {
+    cond_waiter_t *w = cs->head;
+    if (!w) return false;
+    cond_unlink(cs, w);
+    atomic_store_explicit(&w->signaled, 1, memory_order_release);
+    futex(&w->signaled, FUTEX_WAKE_PRIVATE, 1, NULL, 0);
+    return true;
+}
+
+int pthread_cond_init(pthread_cond_t *c, const pthread_condattr_t *attr) {
+    cond_state_t *cs = (cond_state_t *) c;
+    memset(c, 0, sizeof(*c));
+    cs->clock = CLOCK_REALTIME;
+    if (attr) {
+        int pshared = PTHREAD_PROCESS_PRIVATE;
+        pthread_condattr_getclock(attr, &cs->clock);
+        pthread_condattr_getpshared(attr, &pshared);
+        cs->pshared = (pshared == PTHREAD_PROCESS_SHARED);
+    }
+    return 0;
+}
+
+int pthread_cond_destroy(pthread_cond_t *c) {
+    (void) c;
+    return 0;
+}
+
+int pthread_cond_signal(pthread_cond_t *c) {
+    cond_state_t *cs = (cond_state_t *) c;
+    if (cs->pshared) return pthread_cond_broadcast(c);
+    cond_queue_acquire(cs);
+    cond_wake_oldest(cs);
+    cond_queue_release(cs);
+    return 0;
+}
+
+int pthread_cond_broadcast(pthread_cond_t *c) {
+    cond_state_t *cs = (cond_state_t *) c;
+    if (cs->pshared) {
+        atomic_fetch_add(&cs->seq, 1);
+        futex(&cs->seq, FUTEX_WAKE, INT_MAX, NULL, 0);
+        return 0;
+    }
+    cond_queue_acquire(cs);
+    while (cond_wake_oldest(cs)) {}
+    cond_queue_release(cs);
+    return 0;
+}
+
+static int cond_wait_shared(cond_state_t *cs, pthread_mutex_t *m, int op, const struct timespec *abstime) {
+    // Sampled while the mutex is still held, so any signal sent after we
+    // release it changes the word and the futex wait below cannot miss it.
+    unsigned int seq = atomic_load(&cs->seq);
+    pthread_mutex_unlock(m);
+    long rc = futex(&cs->seq, op, seq, abstime, FUTEX_BITSET_MATCH_ANY);
+    int err = (rc == -1 && errno == ETIMEDOUT) ? ETIMEDOUT : 0;
+    pthread_mutex_lock(m);
+    return err;
+}
+
+static int cond_wait_impl(pthread_cond_t *c, pthread_mutex_t *m, clockid_t clock, const struct timespec *abstime) {
+    cond_state_t *cs = (cond_state_t *) c;
+    int clock_flag = clock == CLOCK_REALTIME ? FUTEX_CLOCK_REALTIME : 0;
+    if (cs->pshared) return cond_wait_shared(cs, m, FUTEX_WAIT_BITSET | clock_flag, abstime);
+
+    // Queued while the mutex is still held, so any signal sent after we release it finds us.
+    cond_waiter_t w = {NULL, NULL, 0};
+    cond_queue_acquire(cs);
+    w.prev = cs->tail;
+    if (cs->tail) cs->tail->next = &w;
+    else cs->head = &w;
+    cs->tail = &w;
+    cond_queue_release(cs);
+    pthread_mutex_unlock(m);
+
+    int err = 0;
+    while (!atomic_load_explicit(&w.signaled, memory_order_acquire)) {
+        long rc = futex(&w.signaled, FUTEX_WAIT_BITSET_PRIVATE | clock_flag, 0, abstime, FUTEX_BITSET_MATCH_ANY);
+        if (rc == -1 && errno == ETIMEDOUT) {
+            err = ETIMEDOUT;
+            break;
+        }
+    }
+    cond_queue_acquire(cs);
+    // A signal that raced with the timeout was meant for us; report it rather than lose it.
+    if (atomic_load_explicit(&w.signaled, memory_order_relaxed)) err = 0;
+    else cond_unlink(cs, &w);
+    cond_queue_release(cs);
+
+    pthread_mutex_lock(m);
+    return err;
+}
+
+int pthread_cond_wait(pthread_cond_t *c, pthread_mutex_t *m) {
+    return cond_wait_impl(c, m, CLOCK_REALTIME, NULL);
+}
+
+int pthread_cond_timedwait(pthread_cond_t *c, pthread_mutex_t *m, const struct timespec *abstime) {
+    return cond_wait_impl(c, m, ((cond_state_t *) c)->clock, abstime);
+}
+
+int pthread_cond_clockwait(pthread_cond_t *c, pthread_mutex_t *m, clockid_t clock, const struct timespec *abstime) {
+    return cond_wait_impl(c, m, clock, abstime);
+}
@@ -1,13 +1,50 @@
+#define _GNU_SOURCE
 #include <lock.h> // The unified C/C++ header
+#include <qspinlock.h>
+#include <byte_lock.h>
+#include <sharded_counter.h>
+#include <rcl.h>
+#include <malloc.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
 #include <time.h>
 
 #define MAX_THREADS 20
 // #define INCREMENTS_PER_THREAD 1000
 #define INCREMENTS_PER_THREAD 1000000
+#define SHARDED_COUNTER_BATCH 1024 // Fold threshold for the lock-free counter rows
+
+// --oversubscribe: pin up to OVERSUB_MAX_FACTOR threads per CPU and sample latency.
+#define OVERSUB_MAX_FACTOR 4
+#define OVERSUB_INCREMENTS_PER_THREAD 100000
+#define LATENCY_SAMPLE_EVERY 16
+
+// --footprint: allocate this many locks per type and report heap bytes per lock.
+#define FOOTPRINT_LOCKS 4096
+
+// --nested [depth]: re-acquire the same lock depth times around every increment.
+#define NESTED_DEFAULT_DEPTH 4
+#define NESTED_INCREMENTS_PER_THREAD 200000
+
+// --biased: one owner thread does BIASED_OWNER_OPS increments while an intruder
+// takes the lock BIASED_INTRUSIONS times, BIASED_INTRUDER_GAP_US apart.
+#define BIASED_OWNER_OPS 5000000
+#define BIASED_INTRUSIONS 200
+#define BIASED_INTRUDER_GAP_US 200
+
+// --remote-core: every critical section touches RC_LINES_TOUCHED lines of a shared
+// table, either under LOCK_TYPE_MCS or shipped to a remote core locking server.
+#define RC_OPS_PER_THREAD 100000
+#define RC_TABLE_LINES 32
+#define RC_LINES_TOUCHED 4
+
+// --parking: byte_lock_t against the pthread mutex lock, footprint and throughput.
+#define PARKING_INCREMENTS_PER_THREAD 200000
 
 // --- Shared Data ---
 long long g_shared_counter = 0;
@@ -35,6 +72,13 @@ const char* lock_type_to_string(lock_type_t type) {
         case LOCK_TYPE_TICKET:        return "Ticket Lock";
         case LOCK_TYPE_MCS:           return "MCS Lock";
         case LOCK_TYPE_CLH:           return "CLH Lock";
+        case LOCK_TYPE_MCS_TP:        return "MCS-TP Lock";
+        case LOCK_TYPE_QSPINLOCK:     return "QSpinLock";
+        case LOCK_TYPE_RECURSIVE_TICKET: return "Rec. Ticket";
+        case LOCK_TYPE_RECURSIVE_MCS:    return "Rec. MCS";
+        case LOCK_TYPE_RECURSIVE_CLH:    return "Rec. CLH";
+        case LOCK_TYPE_BIASED_TICKET:    return "Biased Ticket";
+        case LOCK_TYPE_BIASED_MCS:       return "Biased MCS";
         default:                      return "Unknown";
     }
 }
@@ -71,9 +115,541 @@ void run_benchmark(lock_type_t type, int num_threads) {
     g_lock = NULL;
 }
 
-int main() {
+// --- Sharded Counter Runner ---
+// The same increment workload with no lock at all: every thread adds to its CPU's slot.
+static sharded_counter_t *g_sharded_counter = NULL;
+
+void* sharded_worker(void *arg) {
+    (void)arg;
+    for (int i = 0; i < INCREMENTS_PER_THREAD; ++i) {
+        sharded_counter_add(g_sharded_counter, 1);
+    }
+    return NULL;
+}
+
+void run_sharded_counter(int num_threads) {
+    pthread_t threads[MAX_THREADS];
+    g_sharded_counter = sharded_counter_create(SHARDED_COUNTER_BATCH);
+    if (!g_sharded_counter) {
+        fprintf(stderr, "Failed to create sharded counter for benchmark.\n");
+        return;
+    }
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_create(&threads[i], NULL, sharded_worker, NULL);
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double duration = get_time_diff(&start_time, &end_time);
+    long long expected = (long long)num_threads * INCREMENTS_PER_THREAD;
+    const char* result = (sharded_counter_read_exact(g_sharded_counter) == expected) ? "SUCCESS" : "FAIL";
+
+    printf("| %-13s | %3d Threads | %8.4f sec | %s |\n", "Sharded Ctr", num_threads, duration, result);
+
+    sharded_counter_destroy(g_sharded_counter);
+    g_sharded_counter = NULL;
+}
+
+// --- Oversubscribed Benchmark Runner ---
+typedef struct {
+    int cpu;
+    uint64_t *samples;
+    size_t num_samples;
+} oversub_args_t;
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+void* oversub_worker(void *arg) {
+    oversub_args_t *a = arg;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(a->cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+
+    a->num_samples = 0;
+    for (int i = 0; i < OVERSUB_INCREMENTS_PER_THREAD; ++i) {
+        if (i % LATENCY_SAMPLE_EVERY == 0) {
+            uint64_t t0 = now_ns();
+            lock(g_lock);
+            g_shared_counter++;
+            g_lock->unlock(g_lock);
+            a->samples[a->num_samples++] = now_ns() - t0;
+        } else {
+            lock(g_lock);
+            g_shared_counter++;
+            g_lock->unlock(g_lock);
+        }
+    }
+    return NULL;
+}
+
+void run_oversubscribed(lock_type_t type, int num_threads, int num_cores) {
+    size_t per_thread = OVERSUB_INCREMENTS_PER_THREAD / LATENCY_SAMPLE_EVERY + 1;
+    pthread_t *threads = malloc(sizeof(pthread_t) * num_threads);
+    oversub_args_t *args = malloc(sizeof(oversub_args_t) * num_threads);
+    uint64_t *samples = malloc(sizeof(uint64_t) * per_thread * num_threads);
+    g_shared_counter = 0;
+    g_lock = create_lock_object(type);
+    if (!threads || !args || !samples || !g_lock) {
+        fprintf(stderr, "Failed to set up oversubscribed benchmark.\n");
+        goto out;
+    }
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    for (int i = 0; i < num_threads; ++i) {
+        args[i].cpu = i % num_cores; // Round-robin pinning: num_threads / num_cores threads per CPU
+        args[i].samples = samples + per_thread * i;
+        pthread_create(&threads[i], NULL, oversub_worker, &args[i]);
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double duration = get_time_diff(&start_time, &end_time);
+    long long expected = (long long)num_threads * OVERSUB_INCREMENTS_PER_THREAD;
+    const char* result = (g_shared_counter == expected) ? "SUCCESS" : "FAIL";
+
+    size_t total = 0;
+    for (int i = 0; i < num_threads; ++i) {
+        memmove(samples + total, args[i].samples, sizeof(uint64_t) * args[i].num_samples);
+        total += args[i].num_samples;
+    }
+    qsort(samples, total, sizeof(uint64_t), compare_u64);
+
+    printf("| %-13s | %3d Threads | %8.3f Mops/s | %10llu | %10llu | %10llu | %s |\n",
+           lock_type_to_string(type), num_threads, expected / duration / 1e6,
+           (unsigned long long) samples[total * 99 / 100], (unsigned long long) samples[total * 999 / 1000],
+           (unsigned long long) samples[total - 1], result);
+
+out:
+    destroy_lock_object(g_lock);
+    g_lock = NULL;
+    free(samples);
+    free(args);
+    free(threads);
+}
+
+int run_oversubscribed_suite(int num_cores) {
+    printf("--- C Lock Library Oversubscription Benchmark ---\n");
+    printf("Pinning up to %d threads per CPU on %d logical cores; latencies in ns.\n\n",
+           OVERSUB_MAX_FACTOR, num_cores);
+
+    printf("+---------------+-------------+-----------------+------------+------------+------------+----------+\n");
+    printf("| Lock Type     | Thread Count| Throughput      | p99        | p99.9      | max        | Result   |\n");
+    printf("+---------------+-------------+-----------------+------------+------------+------------+----------+\n");
+
+    for (int type = LOCK_TYPE_PTHREAD_MUTEX; type <= LOCK_TYPE_BIASED_MCS; ++type) {
+        for (int factor = 2; factor <= OVERSUB_MAX_FACTOR; factor *= 2) {
+            run_oversubscribed((lock_type_t)type, num_cores * factor, num_cores);
+        }
+        printf("+---------------+-------------+-----------------+------------+------------+------------+----------+\n");
+    }
+    return 0;
+}
+
+// Heap bytes per lock object, measured as the allocator delta over FOOTPRINT_LOCKS creations.
+int run_footprint_suite(void) {
+    printf("--- C Lock Library Footprint ---\n");
+    printf("Heap bytes per lock averaged over %d create_lock_object() calls.\n\n", FOOTPRINT_LOCKS);
+
+    printf("+---------------+-------------+-------------+\n");
+    printf("| Lock Type     | Heap Bytes  | Embedded    |\n");
+    printf("+---------------+-------------+-------------+\n");
+
+    lock_t **locks = malloc(FOOTPRINT_LOCKS * sizeof(lock_t *));
+    if (!locks) return 1;
+    for (int type = LOCK_TYPE_PTHREAD_MUTEX; type <= LOCK_TYPE_BIASED_MCS; ++type) {
+        size_t before = mallinfo2().uordblks;
+        for (int i = 0; i < FOOTPRINT_LOCKS; ++i) locks[i] = create_lock_object((lock_type_t)type);
+        size_t after = mallinfo2().uordblks;
+        for (int i = 0; i < FOOTPRINT_LOCKS; ++i) destroy_lock_object(locks[i]);
+
+        // Only the raw primitives can be embedded without the lock_t wrapper.
+        size_t embedded = type == LOCK_TYPE_PTHREAD_MUTEX ? sizeof(pthread_mutex_t)
+                        : type == LOCK_TYPE_QSPINLOCK     ? sizeof(qspinlock_t) : 0;
+        char embedded_str[16] = "-";
+        if (embedded) snprintf(embedded_str, sizeof(embedded_str), "%zu", embedded);
+        printf("| %-13s | %11zu | %11s |\n", lock_type_to_string((lock_type_t)type),
+               (after - before) / FOOTPRINT_LOCKS, embedded_str);
+    }
+    printf("+---------------+-------------+-------------+\n");
+    free(locks);
+    return 0;
+}
+
+// --- Nested Acquisition Benchmark Runner ---
+// g_lock is NULL while the recursive pthread_mutex_t baseline runs.
+static pthread_mutex_t g_recursive_mutex;
+static int g_nesting_depth = NESTED_DEFAULT_DEPTH;
+
+void* nested_worker(void *arg) {
+    (void)arg;
+    for (int i = 0; i < NESTED_INCREMENTS_PER_THREAD; ++i) {
+        for (int d = 0; d < g_nesting_depth; ++d) {
+            if (g_lock) lock(g_lock);
+            else pthread_mutex_lock(&g_recursive_mutex);
+        }
+        g_shared_counter++;
+        for (int d = 0; d < g_nesting_depth; ++d) {
+            if (g_lock) g_lock->unlock(g_lock);
+            else pthread_mutex_unlock(&g_recursive_mutex);
+        }
+    }
+    return NULL;
+}
+
+void run_nested(const char *name, int num_threads) {
+    pthread_t threads[MAX_THREADS];
+    g_shared_counter = 0;
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_create(&threads[i], NULL, nested_worker, NULL);
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double duration = get_time_diff(&start_time, &end_time);
+    long long expected = (long long)num_threads * NESTED_INCREMENTS_PER_THREAD;
+    const char* result = (g_shared_counter == expected) ? "SUCCESS" : "FAIL";
+    double ns_per_acquire = duration * 1e9 / ((double) expected * g_nesting_depth);
+
+    printf("| %-13s | %3d Threads | %8.4f sec | %7.1f ns | %s |\n",
+           name, num_threads, duration, ns_per_acquire, result);
+}
+
+int run_nested_suite(int num_cores) {
+    printf("--- C Lock Library Nested Acquisition Benchmark ---\n");
+    printf("Each increment acquires the same lock %d times; ns/acquire averages over all of them.\n\n",
+           g_nesting_depth);
+
+    printf("+---------------+-------------+------------+------------+----------+\n");
+    printf("| Lock Type     | Thread Count| Duration   | ns/acquire | Result   |\n");
+    printf("+---------------+-------------+------------+------------+----------+\n");
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&g_recursive_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    for (int threads = 1; threads <= num_cores * 2 && threads <= MAX_THREADS; threads *= 2) {
+        run_nested("Rec. Pthread", threads);
+    }
+    pthread_mutex_destroy(&g_recursive_mutex);
+    printf("+---------------+-------------+------------+------------+----------+\n");
+
+    for (int type = LOCK_TYPE_RECURSIVE_TICKET; type <= LOCK_TYPE_RECURSIVE_CLH; ++type) {
+        for (int threads = 1; threads <= num_cores * 2 && threads <= MAX_THREADS; threads *= 2) {
+            g_lock = create_lock_object((lock_type_t)type);
+            if (!g_lock) {
+                fprintf(stderr, "Failed to create C lock for benchmark.\n");
+                return 1;
+            }
+            run_nested(lock_type_to_string((lock_type_t)type), threads);
+            destroy_lock_object(g_lock);
+            g_lock = NULL;
+        }
+        printf("+---------------+-------------+------------+------------+----------+\n");
+    }
+    return 0;
+}
+
+// --- Biased Lock Benchmark Runner ---
+typedef struct {
+    double owner_ns_per_op;
+    double intruder_ns_per_acquire;
+} biased_result_t;
+
+void* biased_owner(void *arg) {
+    biased_result_t *r = arg;
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    for (int i = 0; i < BIASED_OWNER_OPS; ++i) {
+        lock(g_lock);
+        g_shared_counter++;
+        g_lock->unlock(g_lock);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    r->owner_ns_per_op = get_time_diff(&start_time, &end_time) * 1e9 / BIASED_OWNER_OPS;
+    return NULL;
+}
+
+void* biased_intruder(void *arg) {
+    biased_result_t *r = arg;
+    uint64_t total_ns = 0;
+    for (int i = 0; i < BIASED_INTRUSIONS; ++i) {
+        usleep(BIASED_INTRUDER_GAP_US);
+        uint64_t t0 = now_ns();
+        lock(g_lock);
+        total_ns += now_ns() - t0;
+        g_shared_counter++;
+        g_lock->unlock(g_lock);
+    }
+    r->intruder_ns_per_acquire = (double) total_ns / BIASED_INTRUSIONS;
+    return NULL;
+}
+
+void run_biased(lock_type_t type) {
+    biased_result_t alone = {0, 0}, shared = {0, 0};
+    pthread_t owner, intruder;
+
+    // Owner alone: the single-owner fast path.
+    g_shared_counter = 0;
+    g_lock = create_lock_object(type);
+    if (!g_lock) {
+        fprintf(stderr, "Failed to create C lock for benchmark.\n");
+        return;
+    }
+    pthread_create(&owner, NULL, biased_owner, &alone);
+    pthread_join(owner, NULL);
+    bool ok = g_shared_counter == BIASED_OWNER_OPS;
+    destroy_lock_object(g_lock);
+
+    // Owner plus an occasional intruder: every intrusion may revoke the bias.
+    g_shared_counter = 0;
+    g_lock = create_lock_object(type);
+    if (!g_lock) {
+        fprintf(stderr, "Failed to create C lock for benchmark.\n");
+        return;
+    }
+    pthread_create(&owner, NULL, biased_owner, &shared);
+    pthread_create(&intruder, NULL, biased_intruder, &shared);
+    pthread_join(owner, NULL);
+    pthread_join(intruder, NULL);
+    ok = ok && g_shared_counter == BIASED_OWNER_OPS + BIASED_INTRUSIONS;
+    unsigned long long revocations = lock_bias_revocations(g_lock);
+    destroy_lock_object(g_lock);
+    g_lock = NULL;
+
+    printf("| %-13s | %8.2f ns | %8.2f ns | %9.0f ns | %11llu | %s |\n",
+           lock_type_to_string(type), alone.owner_ns_per_op, shared.owner_ns_per_op,
+           shared.intruder_ns_per_acquire, revocations, ok ? "SUCCESS" : "FAIL");
+}
+
+int run_biased_suite(void) {
+    printf("--- C Lock Library Biased Locking Benchmark ---\n");
+    printf("Owner does %d increments; the intruder takes the lock %d times, %d us apart.\n\n",
+           BIASED_OWNER_OPS, BIASED_INTRUSIONS, BIASED_INTRUDER_GAP_US);
+
+    const char *rule = "+---------------+-------------+-------------+--------------+-------------+----------+\n";
+    printf("%s", rule);
+    printf("| Lock Type     | Owner alone | w/ intruder | Intruder acq | Revocations | Result   |\n");
+    printf("%s", rule);
+    const lock_type_t types[] = {
+        LOCK_TYPE_PTHREAD_MUTEX, LOCK_TYPE_TICKET, LOCK_TYPE_BIASED_TICKET, LOCK_TYPE_MCS, LOCK_TYPE_BIASED_MCS
+    };
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); ++i) {
+        run_biased(types[i]);
+    }
+    printf("%s", rule);
+    return 0;
+}
+
+// --- Remote Core Locking Benchmark Runner ---
+static uint64_t g_rc_table[RC_TABLE_LINES][8] __attribute__((aligned(64)));
+static rcl_server_t *g_rcl = NULL;
+
+static void* rc_critical_section(void *arg) {
+    uintptr_t seed = (uintptr_t) arg;
+    for (int i = 0; i < RC_LINES_TOUCHED; ++i) {
+        g_rc_table[(seed + i * 7) % RC_TABLE_LINES][i]++;
+    }
+    g_shared_counter++;
+    return NULL;
+}
+
+void* rc_worker(void *arg) {
+    uintptr_t seed = (uintptr_t) arg;
+    for (int i = 0; i < RC_OPS_PER_THREAD; ++i, seed += 13) {
+        if (g_rcl) {
+            rcl_execute(g_rcl, rc_critical_section, (void *) seed);
+        } else {
+            lock(g_lock);
+            rc_critical_section((void *) seed);
+            g_lock->unlock(g_lock);
+        }
+    }
+    return NULL;
+}
+
+void run_remote_core(const char *name, int num_threads) {
+    pthread_t threads[MAX_THREADS];
+    g_shared_counter = 0;
+    memset(g_rc_table, 0, sizeof(g_rc_table));
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_create(&threads[i], NULL, rc_worker, (void *) (uintptr_t) i);
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    double duration = get_time_diff(&start_time, &end_time);
+    long long expected = (long long) num_threads * RC_OPS_PER_THREAD;
+    printf("| %-13s | %3d Threads | %8.3f Mops/s | %-8s |\n", name, num_threads,
+           expected / duration / 1e6, g_shared_counter == expected ? "SUCCESS" : "FAIL");
+}
+
+int run_remote_core_suite(int num_cores) {
+    printf("--- C Lock Library Remote Core Locking Benchmark ---\n");
+    printf("Detected %d logical cores. Each critical section touches %d of %d cache lines.\n",
+           num_cores, RC_LINES_TOUCHED, RC_TABLE_LINES);
+    // Keep the server on its own core when there is one to spare.
+    int server_cpu = num_cores > 1 ? num_cores - 1 : -1;
+    printf("Server thread pinned to CPU %d (-1: unpinned).\n\n", server_cpu);
+
+    const char *rule = "+---------------+-------------+-----------------+----------+\n";
+    printf("%s", rule);
+    printf("| Engine        | Thread Count| Throughput      | Result   |\n");
+    printf("%s", rule);
+
+    for (int threads = 2; threads <= MAX_THREADS; threads *= 2) {
+        g_lock = create_lock_object(LOCK_TYPE_MCS);
+        if (!g_lock) {
+            fprintf(stderr, "Failed to create C lock for benchmark.\n");
+            return 1;
+        }
+        run_remote_core(lock_type_to_string(LOCK_TYPE_MCS), threads);
+        destroy_lock_object(g_lock);
+        g_lock = NULL;
+
+        const rcl_idle_t policies[] = {RCL_IDLE_POLL, RCL_IDLE_PARK};
+        for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); ++p) {
+            g_rcl = rcl_server_create(server_cpu, policies[p]);
+            if (!g_rcl) {
+                fprintf(stderr, "Failed to start the remote core locking server.\n");
+                return 1;
+            }
+            run_remote_core(policies[p] == RCL_IDLE_POLL ? "RCL (polling)" : "RCL (parking)", threads);
+            rcl_server_destroy(g_rcl);
+            g_rcl = NULL;
+        }
+        printf("%s", rule);
+    }
+    return 0;
+}
+
+// --- Parking Lot Benchmark Runner ---
+static byte_lock_t g_byte_lock = BYTE_LOCK_INIT;
+
+void* parking_worker(void *arg) {
+    (void)arg;
+    for (int i = 0; i < PARKING_INCREMENTS_PER_THREAD; ++i) {
+        if (g_lock) {
+            lock(g_lock);
+            g_shared_counter++;
+            g_lock->unlock(g_lock);
+        } else {
+            byte_lock_lock(&g_byte_lock);
+            g_shared_counter++;
+            byte_lock_unlock(&g_byte_lock);
+        }
+    }
+    return NULL;
+}
+
+void run_parking(const char *name, size_t embedded, size_t heap, int num_threads) {
+    pthread_t threads[MAX_THREADS];
+    g_shared_counter = 0;
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_create(&threads[i], NULL, parking_worker, NULL);
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    double duration = get_time_diff(&start_time, &end_time);
+    long long expected = (long long) num_threads * PARKING_INCREMENTS_PER_THREAD;
+    printf("| %-13s | %8zu | %10zu | %3d Threads | %8.3f Mops/s | %-8s |\n", name, embedded, heap, num_threads,
+           expected / duration / 1e6, g_shared_counter == expected ? "SUCCESS" : "FAIL");
+}
+
+int run_parking_suite(void) {
+    printf("--- C Lock Library Parking Lot Benchmark ---\n");
+    printf("Embedded: bytes inside the protected object. Heap: bytes per create_lock_object() call.\n\n");
+
+    // Heap bytes behind one pthread mutex lock object, as in --footprint.
+    lock_t **locks = malloc(FOOTPRINT_LOCKS * sizeof(lock_t *));
+    if (!locks) return 1;
+    size_t before = mallinfo2().uordblks;
+    for (int i = 0; i < FOOTPRINT_LOCKS; ++i) locks[i] = create_lock_object(LOCK_TYPE_PTHREAD_MUTEX);
+    size_t mutex_heap = (mallinfo2().uordblks - before) / FOOTPRINT_LOCKS;
+    for (int i = 0; i < FOOTPRINT_LOCKS; ++i) destroy_lock_object(locks[i]);
+    free(locks);
+
+    const char *rule = "+---------------+----------+------------+-------------+-----------------+----------+\n";
+    printf("%s", rule);
+    printf("| Lock Type     | Embedded | Heap Bytes | Thread Count| Throughput      | Result   |\n");
+    printf("%s", rule);
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        g_lock = NULL;
+        run_parking("Byte Lock", sizeof(byte_lock_t), 0, threads);
+
+        g_lock = create_lock_object(LOCK_TYPE_PTHREAD_MUTEX);
+        if (!g_lock) {
+            fprintf(stderr, "Failed to create C lock for benchmark.\n");
+            return 1;
+        }
+        run_parking(lock_type_to_string(LOCK_TYPE_PTHREAD_MUTEX), sizeof(lock_t *), mutex_heap, threads);
+        destroy_lock_object(g_lock);
+        g_lock = NULL;
+        printf("%s", rule);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
     long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
     if (num_cores <= 0) num_cores = 8;
+    if (argc > 1 && strcmp(argv[1], "--oversubscribe") == 0) {
+        return run_oversubscribed_suite((int) num_cores);
+    }
+    if (argc > 1 && strcmp(argv[1], "--footprint") == 0) {
+        return run_footprint_suite();
+    }
+    if (argc > 1 && strcmp(argv[1], "--biased") == 0) {
+        return run_biased_suite();
+    }
+    if (argc > 1 && strcmp(argv[1], "--parking") == 0) {
+        return run_parking_suite();
+    }
+    if (argc > 1 && strcmp(argv[1], "--remote-core") == 0) {
+        return run_remote_core_suite((int) num_cores);
+    }
+    if (argc > 1 && strcmp(argv[1], "--nested") == 0) {
+        if (argc > 2) g_nesting_depth = atoi(argv[2]);
+        if (g_nesting_depth <= 0) g_nesting_depth = NESTED_DEFAULT_DEPTH;
+        return run_nested_suite((int) num_cores);
+    }
     printf("--- C Lock Library Benchmark ---\n");
     printf("Detected %ld logical cores.\n\n", num_cores);
 
@@ -81,12 +657,17 @@ int main() {
     printf("| Lock Type     | Thread Count| Duration   | Result   |\n");
     printf("+---------------+-------------+------------+----------+\n");
 
-    for (int type = LOCK_TYPE_PTHREAD_MUTEX; type <= LOCK_TYPE_CLH; ++type) {
+    for (int type = LOCK_TYPE_PTHREAD_MUTEX; type <= LOCK_TYPE_BIASED_MCS; ++type) {
         for (int threads = 1; threads <= num_cores * 2; threads *= 2) {
              if (threads > MAX_THREADS) break;
              run_benchmark((lock_type_t)type, threads);
         }
         printf("+---------------+-------------+------------+----------+\n");
     }
+    for (int threads = 1; threads <= num_cores * 2; threads *= 2) {
+        if (threads > MAX_THREADS) break;
+        run_sharded_counter(threads);
+    }
+    printf("+---------------+-------------+------------+----------+\n");
     return 0;
 }
@@ -0,0 +1,268 @@
+#define _GNU_SOURCE
+#include <lock.h> // The unified C/C++ header
+#include <epoch.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <time.h>
+
+// Read-mostly chained hash table. Readers either take the bucket's MCS lock or
+// run lock-free inside an epoch read-side section; in the latter case writers
+// still serialize on the bucket lock, replace nodes copy-on-write and retire
+// the old version through the epoch reclaimer.
+//
+// Usage: c_epoch_benchmark [buckets] [ops_per_thread]
+
+#define MAX_THREADS 20
+#define DEFAULT_BUCKETS 1024
+#define DEFAULT_OPS_PER_THREAD 1000000
+#define KEY_SPACE 4096
+#define NODE_MAGIC 0x5EEDF00DCAFEBABEull
+#define NODE_POISON 0xDEADDEADDEADDEADull
+
+typedef enum {
+    READS_LOCKED, // Every read takes LOCK_TYPE_MCS
+    READS_EPOCH   // Reads are lock-free, protected by epoch_enter()/epoch_exit()
+} read_mode_t;
+
+typedef struct node_s {
+    uint64_t key;
+    uint64_t value;
+    uint64_t check; // key ^ value ^ NODE_MAGIC; poisoned when the node is freed
+    _Atomic(struct node_s *) next;
+} node_t;
+
+typedef struct __attribute__((aligned(64))) {
+    lock_t *lock;
+    _Atomic(node_t *) head;
+} bucket_t;
+
+typedef struct {
+    read_mode_t mode;
+    unsigned write_permille;
+    int thread_id;
+    uint64_t sink;
+} worker_args_t;
+
+static int g_buckets = DEFAULT_BUCKETS;
+static long g_ops_per_thread = DEFAULT_OPS_PER_THREAD;
+static bucket_t *g_table = NULL;
+static _Atomic long g_errors = 0;
+static _Atomic long g_retired = 0;
+static _Atomic long g_freed = 0;
+
+// --- Utility Functions ---
+static double get_time_diff(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static inline uint64_t xorshift64(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static const char *read_mode_to_string(read_mode_t mode) {
+    return mode == READS_LOCKED ? "MCS Lock" : "Epoch";
+}
+
+// --- Table ---
+static node_t *node_new(uint64_t key, uint64_t value, node_t *next) {
+    node_t *n = malloc(sizeof(node_t));
+    if (!n) exit(1);
+    n->key = key;
+    n->value = value;
+    n->check = key ^ value ^ NODE_MAGIC;
+    atomic_init(&n->next, next);
+    return n;
+}
+
+static void node_free(void *ptr) {
+    node_t *n = ptr;
+    // A reader that still sees this node after reclamation will trip over the poison.
+    n->check = NODE_POISON;
+    atomic_fetch_add_explicit(&g_freed, 1, memory_order_relaxed);
+    free(n);
+}
+
+static inline bucket_t *table_bucket(uint64_t key) {
+    return &g_table[(key * 0x9E3779B97F4A7C15ull >> 32) % (uint64_t) g_buckets];
+}
+
+static int table_init(void) {
+    g_table = aligned_alloc(64, sizeof(bucket_t) * g_buckets);
+    if (!g_table) return -1;
+    for (int i = 0; i < g_buckets; ++i) {
+        g_table[i].lock = create_lock_object(LOCK_TYPE_MCS);
+        atomic_init(&g_table[i].head, NULL);
+        if (!g_table[i].lock) return -1;
+    }
+    for (uint64_t k = 0; k < KEY_SPACE; ++k) {
+        bucket_t *b = table_bucket(k);
+        atomic_store_explicit(&b->head, node_new(k, k, atomic_load_explicit(&b->head, memory_order_relaxed)),
+                              memory_order_relaxed);
+    }
+    return 0;
+}
+
+// Returns the number of keys still present, which must be KEY_SPACE.
+static long table_destroy(void) {
+    long keys = 0;
+    for (int i = 0; i < g_buckets; ++i) {
+        node_t *n = atomic_load_explicit(&g_table[i].head, memory_order_relaxed);
+        while (n) {
+            node_t *next = atomic_load_explicit(&n->next, memory_order_relaxed);
+            free(n);
+            n = next;
+            ++keys;
+        }
+        destroy_lock_object(g_table[i].lock);
+    }
+    free(g_table);
+    g_table = NULL;
+    return keys;
+}
+
+static inline uint64_t read_node(node_t *n) {
+    if (n->check != (n->key ^ n->value ^ NODE_MAGIC)) {
+        atomic_fetch_add_explicit(&g_errors, 1, memory_order_relaxed);
+    }
+    return n->value;
+}
+
+static uint64_t table_get(read_mode_t mode, uint64_t key) {
+    bucket_t *b = table_bucket(key);
+    uint64_t value = 0;
+    if (mode == READS_LOCKED) lock(b->lock);
+    else epoch_enter();
+    for (node_t *n = atomic_load_explicit(&b->head, memory_order_acquire); n;
+         n = atomic_load_explicit(&n->next, memory_order_acquire)) {
+        if (n->key == key) {
+            value = read_node(n);
+            break;
+        }
+    }
+    if (mode == READS_LOCKED) b->lock->unlock(b->lock);
+    else epoch_exit();
+    return value;
+}
+
+static void table_update(read_mode_t mode, uint64_t key, uint64_t value) {
+    bucket_t *b = table_bucket(key);
+    node_t *old = NULL;
+    lock(b->lock);
+    _Atomic(node_t *) *link = &b->head;
+    for (node_t *n = atomic_load_explicit(link, memory_order_relaxed); n;
+         link = &n->next, n = atomic_load_explicit(link, memory_order_relaxed)) {
+        if (n->key != key) continue;
+        if (mode == READS_LOCKED) {
+            n->value = value;
+            n->check = key ^ value ^ NODE_MAGIC;
+        } else {
+            // Lock-free readers may be looking at n: publish a fresh copy instead.
+            old = n;
+            atomic_store_explicit(link, node_new(key, value, atomic_load_explicit(&n->next, memory_order_relaxed)),
+                                  memory_order_release);
+        }
+        break;
+    }
+    b->lock->unlock(b->lock);
+    if (old) {
+        atomic_fetch_add_explicit(&g_retired, 1, memory_order_relaxed);
+        epoch_retire(old, node_free);
+    }
+}
+
+// --- Benchmark Logic ---
+static void *worker(void *arg) {
+    worker_args_t *a = arg;
+    uint64_t rng = 0x2545F4914F6CDD1Dull ^ ((uint64_t) (a->thread_id + 1) * 0x9E3779B97F4A7C15ull);
+    uint64_t sink = 0;
+    for (long i = 0; i < g_ops_per_thread; ++i) {
+        uint64_t r = xorshift64(&rng);
+        uint64_t key = r % KEY_SPACE;
+        if ((r >> 32) % 1000 < a->write_permille) table_update(a->mode, key, r);
+        else sink += table_get(a->mode, key);
+    }
+    a->sink = sink;
+    return NULL;
+}
+
+static void run_benchmark(read_mode_t mode, unsigned write_permille, int num_threads) {
+    pthread_t threads[MAX_THREADS];
+    worker_args_t args[MAX_THREADS];
+    atomic_store(&g_errors, 0);
+    atomic_store(&g_retired, 0);
+    atomic_store(&g_freed, 0);
+    if (table_init() != 0) {
+        fprintf(stderr, "Failed to set up the table for %s.\n", read_mode_to_string(mode));
+        return;
+    }
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    for (int i = 0; i < num_threads; ++i) {
+        args[i].mode = mode;
+        args[i].write_permille = write_permille;
+        args[i].thread_id = i;
+        pthread_create(&threads[i], NULL, worker, &args[i]);
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double duration = get_time_diff(&start_time, &end_time);
+
+    // Exited workers left their pending retirees behind; two grace periods free them all.
+    for (int i = 0; i < 1000 && atomic_load(&g_freed) < atomic_load(&g_retired); ++i) {
+        epoch_reclaim();
+        sched_yield();
+    }
+
+    long leaked = atomic_load(&g_retired) - atomic_load(&g_freed);
+    long keys = table_destroy();
+    const char *result = (atomic_load(&g_errors) == 0 && leaked == 0 && keys == KEY_SPACE) ? "SUCCESS" : "FAILURE";
+    double mops = (double) num_threads * g_ops_per_thread / duration / 1e6;
+
+    printf("| %-9s | %5.1f%% | %3d Threads | %8.3f Mops/s | %10ld | %-8s |\n",
+           read_mode_to_string(mode), write_permille / 10.0, num_threads, mops,
+           (long) atomic_load(&g_retired), result);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) g_buckets = atoi(argv[1]);
+    if (argc > 2) g_ops_per_thread = atol(argv[2]);
+    if (g_buckets <= 0) g_buckets = DEFAULT_BUCKETS;
+    if (g_ops_per_thread <= 0) g_ops_per_thread = DEFAULT_OPS_PER_THREAD;
+
+    long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_cores <= 0) num_cores = 8;
+    printf("--- C Epoch Reclamation Benchmark ---\n");
+    printf("Detected %ld logical cores. Buckets: %d, keys: %d, ops/thread: %ld.\n\n",
+           num_cores, g_buckets, KEY_SPACE, g_ops_per_thread);
+
+    const char *rule = "+-----------+--------+-------------+-----------------+------------+----------+\n";
+    printf("%s", rule);
+    printf("| Reads via | Writes | Thread Count| Throughput      | Retired    | Result   |\n");
+    printf("%s", rule);
+
+    static const unsigned write_permilles[] = {0, 10, 100};
+    for (size_t w = 0; w < sizeof(write_permilles) / sizeof(write_permilles[0]); ++w) {
+        for (int mode = READS_LOCKED; mode <= READS_EPOCH; ++mode) {
+            for (int threads = 1; threads <= num_cores * 2; threads *= 2) {
+                if (threads > MAX_THREADS) break;
+                run_benchmark((read_mode_t) mode, write_permilles[w], threads);
+            }
+        }
+        printf("%s", rule);
+    }
+    return 0;
+}
@@ -0,0 +1,236 @@
+#define _GNU_SOURCE
+#include <lock.h> // The unified C/C++ header
+#include <guarded.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+// Guarded layout benchmark. Each thread updates randomly chosen guarded
+// records; the number of records sets the contention level (one record means
+// every thread fights over the same lock). Every lock runs once with the data
+// sharing the lock's cache line and once with the data on its own line.
+//
+// The inline qspinlock_t and byte_lock_t rows embed the lock word in the
+// record, so they compare where the lock state sits. Factory locks keep their
+// state on the heap and only the lock_t pointer moves, so those rows report
+// both throughputs but no winner.
+//
+// Usage: c_guarded_benchmark [ops_per_thread]
+
+#define MAX_THREADS 20
+#define DEFAULT_OPS_PER_THREAD 200000
+#define MAX_RECORDS 64
+#define OUTSIDE_WORK 32 // Non-critical iterations between acquisitions
+
+typedef struct {
+    uint64_t hits;
+    uint64_t total;
+    uint64_t last;
+    uint64_t check; // hits ^ total ^ last; a torn update breaks it
+} record_t;
+
+typedef GUARDED(record_t, SHARED_LINE) factory_shared_t;
+typedef GUARDED(record_t, SEPARATE_LINES) factory_separate_t;
+typedef GUARDED_QSPIN(record_t, SHARED_LINE) qspin_shared_t;
+typedef GUARDED_QSPIN(record_t, SEPARATE_LINES) qspin_separate_t;
+typedef GUARDED_BYTE_LOCK(record_t, SHARED_LINE) byte_shared_t;
+typedef GUARDED_BYTE_LOCK(record_t, SEPARATE_LINES) byte_separate_t;
+
+_Static_assert(sizeof(factory_shared_t) == 64, "shared-line record must fit one cache line");
+_Static_assert(sizeof(qspin_shared_t) == 64, "shared-line record must fit one cache line");
+_Static_assert(sizeof(byte_shared_t) == 64, "shared-line record must fit one cache line");
+_Static_assert(offsetof(factory_separate_t, data) == 64, "separate-line data must start a new cache line");
+_Static_assert(offsetof(qspin_separate_t, data) == 64, "separate-line data must start a new cache line");
+_Static_assert(offsetof(byte_separate_t, data) == 64, "separate-line data must start a new cache line");
+
+// One guarded struct type: its records, worker and lock setup.
+typedef struct {
+    bool inline_lock; // The lock word lives in the record, so the layout really moves the lock state
+    void *(*worker)(void *);
+    int (*init)(int i, lock_type_t type); // Inline locks ignore type; returns 0 if the lock could not be created
+    void (*destroy)(int i);
+    record_t *(*data)(int i);
+} layout_ops_t;
+
+static long g_ops_per_thread = DEFAULT_OPS_PER_THREAD;
+static int g_records = 1;
+
+typedef struct {
+    int thread_id;
+    uint64_t sink;
+} worker_args_t;
+
+// --- Utility Functions ---
+static double get_time_diff(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static inline uint64_t xorshift64(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+const char* lock_type_to_string(lock_type_t type) {
+    switch (type) {
+        case LOCK_TYPE_PTHREAD_MUTEX: return "Pthread Mutex";
+        case LOCK_TYPE_TICKET:        return "Ticket Lock";
+        case LOCK_TYPE_MCS:           return "MCS Lock";
+        case LOCK_TYPE_CLH:           return "CLH Lock";
+        case LOCK_TYPE_MCS_TP:        return "MCS-TP Lock";
+        case LOCK_TYPE_QSPINLOCK:     return "QSpinLock";
+        case LOCK_TYPE_RECURSIVE_TICKET: return "Rec. Ticket";
+        case LOCK_TYPE_RECURSIVE_MCS:    return "Rec. MCS";
+        case LOCK_TYPE_RECURSIVE_CLH:    return "Rec. CLH";
+        case LOCK_TYPE_BIASED_TICKET:    return "Biased Ticket";
+        case LOCK_TYPE_BIASED_MCS:       return "Biased MCS";
+        default:                      return "Unknown";
+    }
+}
+
+static inline void record_update(record_t *r, uint64_t value) {
+    r->hits++;
+    r->total += value;
+    r->last = value;
+    r->check = r->hits ^ r->total ^ r->last;
+}
+
+// --- Benchmark Logic ---
+// Each guarded struct is a distinct type, so each gets its own records and worker.
+#define DEFINE_LAYOUT(name, guarded_t, is_inline, WITH, init_expr, destroy_stmt) \
+    static guarded_t name##_records[MAX_RECORDS];                                \
+    static void *name##_worker(void *arg) {                                      \
+        worker_args_t *a = arg;                                                  \
+        uint64_t rng = 0x2545F4914F6CDD1Dull ^                                   \
+                       ((uint64_t) (a->thread_id + 1) * 0x9E3779B97F4A7C15ull);  \
+        uint64_t sink = 0;                                                       \
+        for (long i = 0; i < g_ops_per_thread; ++i) {                            \
+            uint64_t value = xorshift64(&rng);                                   \
+            WITH(&name##_records[value % (uint64_t) g_records], r) {             \
+                record_update(r, value >> 32);                                   \
+            }                                                                    \
+            for (int w = 0; w < OUTSIDE_WORK; ++w) sink += xorshift64(&rng);     \
+        }                                                                        \
+        a->sink = sink;                                                          \
+        return NULL;                                                             \
+    }                                                                            \
+    static int name##_init(int i, lock_type_t type) {                            \
+        guarded_t *g = &name##_records[i];                                       \
+        (void) type;                                                             \
+        record_t zero = {0};                                                     \
+        g->data = zero;                                                          \
+        return init_expr;                                                        \
+    }                                                                            \
+    static void name##_destroy(int i) {                                          \
+        guarded_t *g = &name##_records[i];                                       \
+        (void) g;                                                                \
+        destroy_stmt;                                                            \
+    }                                                                            \
+    static record_t *name##_data(int i) {                                        \
+        return &name##_records[i].data;                                          \
+    }                                                                            \
+    static const layout_ops_t name = {is_inline, name##_worker, name##_init, name##_destroy, name##_data};
+
+DEFINE_LAYOUT(factory_shared, factory_shared_t, false, WITH_GUARDED, guarded_init(g, type), guarded_destroy(g))
+DEFINE_LAYOUT(factory_separate, factory_separate_t, false, WITH_GUARDED, guarded_init(g, type), guarded_destroy(g))
+DEFINE_LAYOUT(qspin_shared, qspin_shared_t, true, WITH_GUARDED_QSPIN, (guarded_qspin_init(g), 1), (void) 0)
+DEFINE_LAYOUT(qspin_separate, qspin_separate_t, true, WITH_GUARDED_QSPIN, (guarded_qspin_init(g), 1), (void) 0)
+DEFINE_LAYOUT(byte_shared, byte_shared_t, true, WITH_GUARDED_BYTE_LOCK, (guarded_byte_lock_init(g), 1), (void) 0)
+DEFINE_LAYOUT(byte_separate, byte_separate_t, true, WITH_GUARDED_BYTE_LOCK, (guarded_byte_lock_init(g), 1), (void) 0)
+
+// Returns throughput in Mops/s, or a negative value if the run failed.
+static double run_layout(const char *name, const layout_ops_t *layout, lock_type_t type, int num_threads) {
+    pthread_t threads[MAX_THREADS];
+    worker_args_t args[MAX_THREADS];
+    int ok = 1;
+
+    for (int i = 0; i < g_records; ++i) {
+        ok &= layout->init(i, type);
+    }
+    if (!ok) {
+        fprintf(stderr, "Failed to create locks for %s.\n", name);
+        return -1.0;
+    }
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    for (int i = 0; i < num_threads; ++i) {
+        args[i].thread_id = i;
+        pthread_create(&threads[i], NULL, layout->worker, &args[i]);
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double duration = get_time_diff(&start_time, &end_time);
+
+    uint64_t hits = 0;
+    for (int i = 0; i < g_records; ++i) {
+        record_t *r = layout->data(i);
+        if (r->check != (r->hits ^ r->total ^ r->last)) ok = 0;
+        hits += r->hits;
+        layout->destroy(i);
+    }
+    if (!ok || hits != (uint64_t) num_threads * g_ops_per_thread) return -1.0;
+    return (double) num_threads * g_ops_per_thread / duration / 1e6;
+}
+
+static void run_benchmark(const char *name, const layout_ops_t *shared_layout, const layout_ops_t *separate_layout,
+                          lock_type_t type, int num_threads) {
+    double shared = run_layout(name, shared_layout, type, num_threads);
+    double separate = run_layout(name, separate_layout, type, num_threads);
+    const char *result = (shared >= 0 && separate >= 0) ? "SUCCESS" : "FAILURE";
+    // Only an inline lock's state moves with the layout; a factory lock's stays on the heap.
+    const char *winner = !shared_layout->inline_lock ? "-" : shared >= separate ? "Shared" : "Separate";
+
+    printf("| %-18s | %7d | %3d Threads | %8.3f Mops/s | %8.3f Mops/s | %-8s | %-8s |\n",
+           name, g_records, num_threads, shared, separate, winner, result);
+}
+
+static void run_thread_sweep(const char *name, const layout_ops_t *shared_layout, const layout_ops_t *separate_layout,
+                             lock_type_t type, long num_cores) {
+    for (int threads = 1; threads <= num_cores * 2; threads *= 2) {
+        if (threads > MAX_THREADS) break;
+        run_benchmark(name, shared_layout, separate_layout, type, threads);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) g_ops_per_thread = atol(argv[1]);
+    if (g_ops_per_thread <= 0) g_ops_per_thread = DEFAULT_OPS_PER_THREAD;
+
+    long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_cores <= 0) num_cores = 8;
+    printf("--- C Guarded Layout Benchmark ---\n");
+    printf("Detected %ld logical cores. Ops/thread: %ld, outside work: %d iterations.\n\n",
+           num_cores, g_ops_per_thread, OUTSIDE_WORK);
+
+    const char *rule =
+        "+--------------------+---------+-------------+-----------------+-----------------+----------+----------+\n";
+    printf("%s", rule);
+    printf("| Lock               | Records | Thread Count| Shared Line     | Separate Lines  | Winner   | Result   |\n");
+    printf("%s", rule);
+
+    // One record is full contention; more records spread the threads out.
+    static const int record_counts[] = {1, 8, MAX_RECORDS};
+    for (size_t c = 0; c < sizeof(record_counts) / sizeof(record_counts[0]); ++c) {
+        g_records = record_counts[c];
+        for (int type = LOCK_TYPE_PTHREAD_MUTEX; type <= LOCK_TYPE_BIASED_MCS; ++type) {
+            run_thread_sweep(lock_type_to_string((lock_type_t) type), &factory_shared, &factory_separate,
+                             (lock_type_t) type, num_cores);
+        }
+        run_thread_sweep("QSpinLock (inline)", &qspin_shared, &qspin_separate, LOCK_TYPE_QSPINLOCK, num_cores);
+        run_thread_sweep("Byte Lock (inline)", &byte_shared, &byte_separate, LOCK_TYPE_PTHREAD_MUTEX, num_cores);
+        printf("%s", rule);
+    }
+    return 0;
+}
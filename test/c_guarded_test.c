@@ -0,0 +1,122 @@
+#include "guarded.h"
+#include <stdio.h>
+
+// Checks how WITH_GUARDED* blocks are left. break and continue bind to the
+// macro's hidden loops, so they leave the guarded block and the enclosing loop
+// keeps going; return leaves the function. The lock must be free afterwards in
+// every case.
+
+struct counter {
+    int value;
+};
+
+typedef GUARDED_QSPIN(struct counter, SHARED_LINE) guarded_counter_t;
+typedef GUARDED_BYTE_LOCK(struct counter, SEPARATE_LINES) guarded_byte_counter_t;
+typedef GUARDED(struct counter, SEPARATE_LINES) guarded_factory_counter_t;
+
+static int g_failures = 0;
+
+static void check(int ok, const char *what) {
+    if (!ok) {
+        printf("FAILURE: %s\n", what);
+        g_failures++;
+    }
+}
+
+static int qspin_is_free(qspinlock_t *l) {
+    if (!qspin_trylock(l)) return 0;
+    qspin_unlock(l);
+    return 1;
+}
+
+static int increment_until(guarded_counter_t *g, int limit) {
+    WITH_GUARDED_QSPIN(g, c) {
+        if (c->value >= limit) return c->value;
+        c->value++;
+    }
+    return -1;
+}
+
+int main(void) {
+    guarded_counter_t g;
+    guarded_qspin_init(&g);
+    g.data.value = 0;
+
+    // break leaves only the guarded block: all four outer iterations run.
+    int iterations = 0;
+    for (int i = 0; i < 4; ++i) {
+        iterations++;
+        WITH_GUARDED_QSPIN(&g, c) {
+            if (i == 1) break;
+            c->value++;
+        }
+        check(qspin_is_free(&g.lock), "qspin lock held after break");
+    }
+    check(iterations == 4, "break inside WITH_GUARDED_QSPIN left the enclosing loop");
+    check(g.data.value == 3, "break did not skip the rest of the block");
+
+    // continue behaves the same way: it ends the guarded block, not the outer iteration.
+    int after_block = 0;
+    g.data.value = 0;
+    for (int i = 0; i < 4; ++i) {
+        WITH_GUARDED_QSPIN(&g, c) {
+            if (i % 2) continue;
+            c->value++;
+        }
+        after_block++;
+    }
+    check(after_block == 4, "continue inside WITH_GUARDED_QSPIN skipped the enclosing loop body");
+    check(g.data.value == 2, "continue did not skip the rest of the block");
+    check(qspin_is_free(&g.lock), "qspin lock held after continue");
+
+    // To leave the enclosing loop, set a flag and test it after the block.
+    int stop = 0;
+    iterations = 0;
+    for (int i = 0; i < 4 && !stop; ++i) {
+        iterations++;
+        WITH_GUARDED_QSPIN(&g, c) {
+            stop = c->value >= 2;
+        }
+    }
+    check(iterations == 1, "flag did not stop the enclosing loop");
+
+    // return releases the lock on the way out.
+    g.data.value = 0;
+    check(increment_until(&g, 1) == -1, "first increment_until returned early");
+    check(increment_until(&g, 1) == 1, "return from the block lost the value");
+    check(qspin_is_free(&g.lock), "qspin lock held after return");
+
+    guarded_byte_counter_t b;
+    guarded_byte_lock_init(&b);
+    b.data.value = 0;
+    for (int i = 0; i < 2; ++i) {
+        WITH_GUARDED_BYTE_LOCK(&b, c) {
+            c->value++;
+            break;
+        }
+    }
+    check(b.data.value == 2, "break inside WITH_GUARDED_BYTE_LOCK left the enclosing loop");
+    if (byte_lock_trylock(&b.lock)) byte_lock_unlock(&b.lock);
+    else check(0, "byte lock held after break");
+
+    guarded_factory_counter_t f;
+    if (!guarded_init(&f, LOCK_TYPE_TICKET)) {
+        printf("FAILURE: could not create lock\n");
+        return 1;
+    }
+    f.data.value = 0;
+    for (int i = 0; i < 2; ++i) {
+        WITH_GUARDED(&f, c) {
+            c->value++;
+            break;
+        }
+    }
+    check(f.data.value == 2, "break inside WITH_GUARDED left the enclosing loop");
+    if (trylock(f.lock)) f.lock->unlock(f.lock);
+    else check(0, "factory lock held after break");
+    guarded_destroy(&f);
+
+    if (g_failures) return 1;
+    printf("SUCCESS: WITH_GUARDED blocks release their lock on break, continue and return\n");
+    return 0;
+}
@@ -0,0 +1,477 @@
+#define _GNU_SOURCE
+#include <lock.h> // The unified C/C++ header
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+// Application-level workloads built on lock_t: a sharded hash map, a bounded
+// MPMC queue and an LRU cache. Each one is run over every lock type and
+// reports throughput plus sampled per-operation tail latency.
+//
+// Usage: c_macro_benchmark [buckets] [ops_per_thread]
+
+#define MAX_THREADS 20
+#define DEFAULT_BUCKETS 1024
+#define DEFAULT_OPS_PER_THREAD 200000
+#define LATENCY_SAMPLE_EVERY 16
+#define KEY_SPACE 16384
+#define QUEUE_CAPACITY 1024
+#define LRU_CAPACITY 4096
+#define LRU_INDEX_BUCKETS 8192
+
+typedef enum {
+    WORKLOAD_HASHMAP,
+    WORKLOAD_QUEUE,
+    WORKLOAD_LRU_READ_MOSTLY,
+    WORKLOAD_LRU_MIXED
+} workload_t;
+
+static int g_buckets = DEFAULT_BUCKETS;
+static long g_ops_per_thread = DEFAULT_OPS_PER_THREAD;
+
+// --- Utility Functions ---
+static double get_time_diff(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static inline uint64_t xorshift64(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+static const char *lock_type_to_string(lock_type_t type) {
+    switch (type) {
+        case LOCK_TYPE_PTHREAD_MUTEX: return "Pthread Mutex";
+        case LOCK_TYPE_TICKET:        return "Ticket Lock";
+        case LOCK_TYPE_MCS:           return "MCS Lock";
+        case LOCK_TYPE_CLH:           return "CLH Lock";
+        case LOCK_TYPE_MCS_TP:        return "MCS-TP Lock";
+        case LOCK_TYPE_QSPINLOCK:     return "QSpinLock";
+        case LOCK_TYPE_RECURSIVE_TICKET: return "Rec. Ticket";
+        case LOCK_TYPE_RECURSIVE_MCS:    return "Rec. MCS";
+        case LOCK_TYPE_RECURSIVE_CLH:    return "Rec. CLH";
+        case LOCK_TYPE_BIASED_TICKET:    return "Biased Ticket";
+        case LOCK_TYPE_BIASED_MCS:       return "Biased MCS";
+        default:                      return "Unknown";
+    }
+}
+
+static const char *workload_to_string(workload_t w) {
+    switch (w) {
+        case WORKLOAD_HASHMAP:         return "Hash Map";
+        case WORKLOAD_QUEUE:           return "MPMC Queue";
+        case WORKLOAD_LRU_READ_MOSTLY: return "LRU 90/10";
+        case WORKLOAD_LRU_MIXED:       return "LRU 50/50";
+        default:                       return "Unknown";
+    }
+}
+
+// --- Sharded Hash Map ---
+typedef struct hm_entry_s {
+    uint64_t key;
+    uint64_t value;
+    struct hm_entry_s *next;
+} hm_entry_t;
+
+typedef struct __attribute__((aligned(64))) {
+    lock_t *lock;
+    hm_entry_t *head;
+} hm_bucket_t;
+
+typedef struct {
+    hm_bucket_t *buckets;
+    int num_buckets;
+} hashmap_t;
+
+static int hashmap_init(hashmap_t *m, lock_type_t type, int num_buckets) {
+    m->num_buckets = num_buckets;
+    m->buckets = aligned_alloc(64, sizeof(hm_bucket_t) * num_buckets);
+    if (!m->buckets) return -1;
+    for (int i = 0; i < num_buckets; ++i) {
+        m->buckets[i].head = NULL;
+        m->buckets[i].lock = create_lock_object(type);
+        if (!m->buckets[i].lock) return -1;
+    }
+    return 0;
+}
+
+static void hashmap_destroy(hashmap_t *m) {
+    for (int i = 0; i < m->num_buckets; ++i) {
+        hm_entry_t *e = m->buckets[i].head;
+        while (e) {
+            hm_entry_t *next = e->next;
+            free(e);
+            e = next;
+        }
+        destroy_lock_object(m->buckets[i].lock);
+    }
+    free(m->buckets);
+}
+
+static inline hm_bucket_t *hashmap_bucket(hashmap_t *m, uint64_t key) {
+    return &m->buckets[(key * 0x9E3779B97F4A7C15ull >> 32) % (uint64_t) m->num_buckets];
+}
+
+static bool hashmap_get(hashmap_t *m, uint64_t key, uint64_t *value) {
+    hm_bucket_t *b = hashmap_bucket(m, key);
+    bool found = false;
+    lock(b->lock);
+    for (hm_entry_t *e = b->head; e; e = e->next) {
+        if (e->key == key) {
+            *value = e->value;
+            found = true;
+            break;
+        }
+    }
+    b->lock->unlock(b->lock);
+    return found;
+}
+
+static void hashmap_put(hashmap_t *m, uint64_t key, uint64_t value) {
+    hm_bucket_t *b = hashmap_bucket(m, key);
+    // Allocate outside the critical section; free it if the key already exists.
+    hm_entry_t *fresh = malloc(sizeof(hm_entry_t));
+    if (!fresh) exit(1);
+    fresh->key = key;
+    fresh->value = value;
+    lock(b->lock);
+    for (hm_entry_t *e = b->head; e; e = e->next) {
+        if (e->key == key) {
+            e->value = value;
+            b->lock->unlock(b->lock);
+            free(fresh);
+            return;
+        }
+    }
+    fresh->next = b->head;
+    b->head = fresh;
+    b->lock->unlock(b->lock);
+}
+
+static void hashmap_erase(hashmap_t *m, uint64_t key) {
+    hm_bucket_t *b = hashmap_bucket(m, key);
+    hm_entry_t *victim = NULL;
+    lock(b->lock);
+    for (hm_entry_t **pp = &b->head; *pp; pp = &(*pp)->next) {
+        if ((*pp)->key == key) {
+            victim = *pp;
+            *pp = victim->next;
+            break;
+        }
+    }
+    b->lock->unlock(b->lock);
+    free(victim);
+}
+
+// --- Bounded MPMC Queue ---
+typedef struct {
+    lock_t *lock;
+    uint64_t slots[QUEUE_CAPACITY];
+    size_t head;
+    size_t tail;
+    size_t count;
+} mpmc_queue_t;
+
+static bool queue_try_push(mpmc_queue_t *q, uint64_t v) {
+    bool ok = false;
+    lock(q->lock);
+    if (q->count < QUEUE_CAPACITY) {
+        q->slots[q->tail] = v;
+        q->tail = (q->tail + 1) % QUEUE_CAPACITY;
+        q->count++;
+        ok = true;
+    }
+    q->lock->unlock(q->lock);
+    return ok;
+}
+
+static bool queue_try_pop(mpmc_queue_t *q, uint64_t *v) {
+    bool ok = false;
+    lock(q->lock);
+    if (q->count > 0) {
+        *v = q->slots[q->head];
+        q->head = (q->head + 1) % QUEUE_CAPACITY;
+        q->count--;
+        ok = true;
+    }
+    q->lock->unlock(q->lock);
+    return ok;
+}
+
+// --- LRU Cache ---
+typedef struct lru_node_s {
+    uint64_t key;
+    uint64_t value;
+    struct lru_node_s *prev, *next; // recency list
+    struct lru_node_s *chain;       // hash index chain
+} lru_node_t;
+
+typedef struct {
+    lock_t *lock;
+    lru_node_t *index[LRU_INDEX_BUCKETS];
+    lru_node_t nodes[LRU_CAPACITY];
+    lru_node_t *mru, *lru;
+    size_t used;
+} lru_cache_t;
+
+static inline size_t lru_slot(uint64_t key) {
+    return (key * 0x9E3779B97F4A7C15ull >> 32) % LRU_INDEX_BUCKETS;
+}
+
+static void lru_unlink(lru_cache_t *c, lru_node_t *n) {
+    if (n->prev) n->prev->next = n->next;
+    else c->mru = n->next;
+    if (n->next) n->next->prev = n->prev;
+    else c->lru = n->prev;
+}
+
+static void lru_push_front(lru_cache_t *c, lru_node_t *n) {
+    n->prev = NULL;
+    n->next = c->mru;
+    if (c->mru) c->mru->prev = n;
+    c->mru = n;
+    if (!c->lru) c->lru = n;
+}
+
+static void lru_index_remove(lru_cache_t *c, lru_node_t *n) {
+    for (lru_node_t **pp = &c->index[lru_slot(n->key)]; *pp; pp = &(*pp)->chain) {
+        if (*pp == n) {
+            *pp = n->chain;
+            return;
+        }
+    }
+}
+
+static lru_node_t *lru_find(lru_cache_t *c, uint64_t key) {
+    for (lru_node_t *n = c->index[lru_slot(key)]; n; n = n->chain) {
+        if (n->key == key) return n;
+    }
+    return NULL;
+}
+
+static bool lru_get(lru_cache_t *c, uint64_t key, uint64_t *value) {
+    lock(c->lock);
+    lru_node_t *n = lru_find(c, key);
+    if (n) {
+        *value = n->value;
+        lru_unlink(c, n);
+        lru_push_front(c, n);
+    }
+    c->lock->unlock(c->lock);
+    return n != NULL;
+}
+
+static void lru_put(lru_cache_t *c, uint64_t key, uint64_t value) {
+    lock(c->lock);
+    lru_node_t *n = lru_find(c, key);
+    if (n) {
+        lru_unlink(c, n);
+    } else {
+        if (c->used < LRU_CAPACITY) {
+            n = &c->nodes[c->used++];
+        } else {
+            n = c->lru;
+            lru_unlink(c, n);
+            lru_index_remove(c, n);
+        }
+        n->key = key;
+        size_t slot = lru_slot(key);
+        n->chain = c->index[slot];
+        c->index[slot] = n;
+    }
+    n->value = value;
+    lru_push_front(c, n);
+    c->lock->unlock(c->lock);
+}
+
+// --- Benchmark Runner ---
+typedef struct {
+    workload_t workload;
+    int thread_id;
+    uint64_t *samples;
+    size_t num_samples;
+} worker_args_t;
+
+static hashmap_t g_map;
+static mpmc_queue_t g_queue;
+static lru_cache_t *g_lru;
+
+static inline void run_one_op(workload_t workload, uint64_t *rng, long i) {
+    uint64_t r = xorshift64(rng);
+    uint64_t key = r % KEY_SPACE;
+    uint64_t value;
+    switch (workload) {
+        case WORKLOAD_HASHMAP: {
+            unsigned pct = (unsigned) (r >> 40) % 100;
+            if (pct < 80) hashmap_get(&g_map, key, &value);
+            else if (pct < 90) hashmap_put(&g_map, key, r);
+            else hashmap_erase(&g_map, key);
+            break;
+        }
+        case WORKLOAD_QUEUE:
+            if (i & 1) queue_try_pop(&g_queue, &value);
+            else queue_try_push(&g_queue, r);
+            break;
+        case WORKLOAD_LRU_READ_MOSTLY:
+        case WORKLOAD_LRU_MIXED: {
+            unsigned read_pct = (workload == WORKLOAD_LRU_READ_MOSTLY) ? 90 : 50;
+            // Skew keys towards a hot set so the cache sees realistic hit rates.
+            key = ((r >> 40) % 100 < 80) ? key % (LRU_CAPACITY / 2) : key;
+            if ((unsigned) (r >> 20) % 100 < read_pct) {
+                if (!lru_get(g_lru, key, &value)) lru_put(g_lru, key, r);
+            } else {
+                lru_put(g_lru, key, r);
+            }
+            break;
+        }
+    }
+}
+
+static void *worker(void *arg) {
+    worker_args_t *a = arg;
+    uint64_t rng = 0x2545F4914F6CDD1Dull ^ ((uint64_t) (a->thread_id + 1) * 0x9E3779B97F4A7C15ull);
+    a->num_samples = 0;
+    for (long i = 0; i < g_ops_per_thread; ++i) {
+        if (i % LATENCY_SAMPLE_EVERY == 0) {
+            uint64_t t0 = now_ns();
+            run_one_op(a->workload, &rng, i);
+            a->samples[a->num_samples++] = now_ns() - t0;
+        } else {
+            run_one_op(a->workload, &rng, i);
+        }
+    }
+    return NULL;
+}
+
+static int setup_workload(workload_t workload, lock_type_t type) {
+    switch (workload) {
+        case WORKLOAD_HASHMAP:
+            if (hashmap_init(&g_map, type, g_buckets) != 0) return -1;
+            // Pre-populate half of the key space.
+            for (uint64_t k = 0; k < KEY_SPACE; k += 2) hashmap_put(&g_map, k, k);
+            return 0;
+        case WORKLOAD_QUEUE:
+            memset(&g_queue, 0, sizeof(g_queue));
+            g_queue.lock = create_lock_object(type);
+            return g_queue.lock ? 0 : -1;
+        case WORKLOAD_LRU_READ_MOSTLY:
+        case WORKLOAD_LRU_MIXED:
+            g_lru = calloc(1, sizeof(lru_cache_t));
+            if (!g_lru) return -1;
+            g_lru->lock = create_lock_object(type);
+            return g_lru->lock ? 0 : -1;
+    }
+    return -1;
+}
+
+static void teardown_workload(workload_t workload) {
+    switch (workload) {
+        case WORKLOAD_HASHMAP:
+            hashmap_destroy(&g_map);
+            break;
+        case WORKLOAD_QUEUE:
+            destroy_lock_object(g_queue.lock);
+            break;
+        case WORKLOAD_LRU_READ_MOSTLY:
+        case WORKLOAD_LRU_MIXED:
+            destroy_lock_object(g_lru->lock);
+            free(g_lru);
+            g_lru = NULL;
+            break;
+    }
+}
+
+static void run_benchmark(workload_t workload, lock_type_t type, int num_threads) {
+    pthread_t threads[MAX_THREADS];
+    worker_args_t args[MAX_THREADS];
+    size_t samples_per_thread = (size_t) (g_ops_per_thread / LATENCY_SAMPLE_EVERY + 1);
+    uint64_t *samples = malloc(sizeof(uint64_t) * samples_per_thread * num_threads);
+    if (!samples || setup_workload(workload, type) != 0) {
+        fprintf(stderr, "Failed to set up %s with %s.\n", workload_to_string(workload), lock_type_to_string(type));
+        free(samples);
+        return;
+    }
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    for (int i = 0; i < num_threads; ++i) {
+        args[i].workload = workload;
+        args[i].thread_id = i;
+        args[i].samples = samples + samples_per_thread * i;
+        pthread_create(&threads[i], NULL, worker, &args[i]);
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double duration = get_time_diff(&start_time, &end_time);
+
+    // Compact the per-thread sample buffers and sort them for percentiles.
+    size_t total = 0;
+    for (int i = 0; i < num_threads; ++i) {
+        memmove(samples + total, args[i].samples, sizeof(uint64_t) * args[i].num_samples);
+        total += args[i].num_samples;
+    }
+    qsort(samples, total, sizeof(uint64_t), compare_u64);
+    uint64_t p50 = samples[total * 50 / 100];
+    uint64_t p99 = samples[total * 99 / 100];
+    uint64_t p999 = samples[total * 999 / 1000];
+    double mops = (double) num_threads * g_ops_per_thread / duration / 1e6;
+
+    printf("| %-10s | %-13s | %3d Threads | %8.3f Mops/s | %8llu | %8llu | %9llu |\n",
+           workload_to_string(workload), lock_type_to_string(type), num_threads, mops,
+           (unsigned long long) p50, (unsigned long long) p99, (unsigned long long) p999);
+
+    teardown_workload(workload);
+    free(samples);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) g_buckets = atoi(argv[1]);
+    if (argc > 2) g_ops_per_thread = atol(argv[2]);
+    if (g_buckets <= 0) g_buckets = DEFAULT_BUCKETS;
+    if (g_ops_per_thread <= 0) g_ops_per_thread = DEFAULT_OPS_PER_THREAD;
+
+    long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_cores <= 0) num_cores = 8;
+    printf("--- C Lock Library Macro-Benchmark ---\n");
+    printf("Detected %ld logical cores. Hash map buckets: %d, ops/thread: %ld.\n",
+           num_cores, g_buckets, g_ops_per_thread);
+    printf("Latencies are sampled every %d ops and reported in ns.\n\n", LATENCY_SAMPLE_EVERY);
+
+    const char *rule = "+------------+---------------+-------------+-----------------+----------+----------+-----------+\n";
+    printf("%s", rule);
+    printf("| Workload   | Lock Type     | Thread Count| Throughput      | p50      | p99      | p99.9     |\n");
+    printf("%s", rule);
+
+    for (int workload = WORKLOAD_HASHMAP; workload <= WORKLOAD_LRU_MIXED; ++workload) {
+        for (int type = LOCK_TYPE_PTHREAD_MUTEX; type <= LOCK_TYPE_BIASED_MCS; ++type) {
+            for (int threads = 1; threads <= num_cores * 2; threads *= 2) {
+                if (threads > MAX_THREADS) break;
+                run_benchmark((workload_t) workload, (lock_type_t) type, threads);
+            }
+        }
+        printf("%s", rule);
+    }
+    return 0;
+}
@@ -0,0 +1,256 @@
+#define _GNU_SOURCE
+#include <lock.h> // The unified C/C++ header
+#include <percpu.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+// Fixed-size object allocator. Every mode shares a central depot: a freelist
+// under one lock that carves new objects out of chunks when it runs dry. The
+// global modes allocate and free straight from the depot, under a ticket or an
+// MCS lock. The per-CPU modes put a percpu_t freelist in front of it: frees
+// push onto the current CPU's list and allocations pop from it, falling back to
+// the depot only when that list is empty. The rseq mode does this without
+// atomics; the locked mode takes a per-CPU MCS lock instead.
+//
+// Each thread repeatedly allocates a batch of objects, writes them and frees
+// them again, like a request handler with short-lived buffers.
+//
+// Usage: c_percpu_benchmark [rounds_per_thread] [batch]
+
+#define MAX_THREADS 20
+#define DEFAULT_ROUNDS_PER_THREAD 200000
+#define DEFAULT_BATCH 8
+#define MAX_BATCH 64
+#define CHUNK_OBJECTS 64
+#define OBJ_LIVE 0x0B1EC7A11C0FFEEull
+#define OBJ_FREE 0xF4EEF4EEF4EEF4EEull
+
+typedef enum {
+    FREELIST_TICKET,       // Global freelist under LOCK_TYPE_TICKET
+    FREELIST_MCS,          // Global freelist under LOCK_TYPE_MCS
+    FREELIST_PERCPU_RSEQ,  // Per-CPU freelists updated in rseq critical sections
+    FREELIST_PERCPU_LOCKED // Per-CPU freelists, each under its own LOCK_TYPE_MCS
+} freelist_mode_t;
+
+typedef struct {
+    percpu_node_t node; // First, so a percpu_node_t * is the object
+    uint64_t state;     // OBJ_FREE on a freelist, OBJ_LIVE ^ owner while allocated
+    uint64_t payload[6];
+} obj_t;
+
+typedef struct chunk_s {
+    struct chunk_s *next;
+    obj_t objs[CHUNK_OBJECTS];
+} chunk_t;
+
+typedef struct __attribute__((aligned(64))) {
+    lock_t *lock;
+    percpu_node_t *head;
+    chunk_t *chunks;
+    long created;
+} depot_t;
+
+typedef struct {
+    freelist_mode_t mode;
+    int thread_id;
+} worker_args_t;
+
+static long g_rounds_per_thread = DEFAULT_ROUNDS_PER_THREAD;
+static int g_batch = DEFAULT_BATCH;
+static depot_t g_depot;
+static percpu_t *g_percpu = NULL;
+static _Atomic long g_errors = 0;
+
+// --- Utility Functions ---
+static double get_time_diff(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static const char *freelist_mode_to_string(freelist_mode_t mode) {
+    switch (mode) {
+        case FREELIST_TICKET: return "Ticket Global";
+        case FREELIST_MCS: return "MCS Global";
+        case FREELIST_PERCPU_RSEQ: return "Per-CPU rseq";
+        case FREELIST_PERCPU_LOCKED: return "Per-CPU MCS";
+        default: return "Unknown";
+    }
+}
+
+// --- Depot ---
+static int depot_init(lock_type_t type) {
+    g_depot.lock = create_lock_object(type);
+    g_depot.head = NULL;
+    g_depot.chunks = NULL;
+    g_depot.created = 0;
+    return g_depot.lock ? 0 : -1;
+}
+
+static obj_t *depot_get(void) {
+    lock(g_depot.lock);
+    if (!g_depot.head) {
+        chunk_t *c = malloc(sizeof(chunk_t));
+        if (!c) exit(1);
+        c->next = g_depot.chunks;
+        g_depot.chunks = c;
+        for (int i = 0; i < CHUNK_OBJECTS; ++i) {
+            c->objs[i].state = OBJ_FREE;
+            c->objs[i].node.next = g_depot.head;
+            g_depot.head = &c->objs[i].node;
+        }
+        g_depot.created += CHUNK_OBJECTS;
+    }
+    percpu_node_t *n = g_depot.head;
+    g_depot.head = n->next;
+    g_depot.lock->unlock(g_depot.lock);
+    return (obj_t *) n;
+}
+
+static void depot_put(obj_t *o) {
+    lock(g_depot.lock);
+    o->node.next = g_depot.head;
+    g_depot.head = &o->node;
+    g_depot.lock->unlock(g_depot.lock);
+}
+
+static long count_list(percpu_node_t *n) {
+    long count = 0;
+    for (; n; n = n->next) {
+        if (((obj_t *) n)->state != OBJ_FREE) atomic_fetch_add_explicit(&g_errors, 1, memory_order_relaxed);
+        ++count;
+    }
+    return count;
+}
+
+// Returns the number of objects that were lost or duplicated; 0 if every object is accounted for.
+static long depot_destroy(void) {
+    long found = count_list(g_depot.head);
+    if (g_percpu) {
+        for (int cpu = 0; cpu < percpu_nr_cpus(g_percpu); ++cpu) {
+            found += count_list(percpu_drain(g_percpu, cpu));
+        }
+    }
+    long lost = g_depot.created - found;
+    while (g_depot.chunks) {
+        chunk_t *next = g_depot.chunks->next;
+        free(g_depot.chunks);
+        g_depot.chunks = next;
+    }
+    destroy_lock_object(g_depot.lock);
+    return lost;
+}
+
+// --- Allocator ---
+static inline obj_t *obj_alloc(freelist_mode_t mode, uint64_t owner) {
+    obj_t *o = NULL;
+    if (mode == FREELIST_PERCPU_RSEQ || mode == FREELIST_PERCPU_LOCKED) o = (obj_t *) percpu_pop(g_percpu);
+    if (!o) o = depot_get();
+    // An object handed out twice would already be marked live.
+    if (o->state != OBJ_FREE) atomic_fetch_add_explicit(&g_errors, 1, memory_order_relaxed);
+    o->state = OBJ_LIVE ^ owner;
+    return o;
+}
+
+static inline void obj_free(freelist_mode_t mode, obj_t *o, uint64_t owner) {
+    if (o->state != (OBJ_LIVE ^ owner)) atomic_fetch_add_explicit(&g_errors, 1, memory_order_relaxed);
+    o->state = OBJ_FREE;
+    if (mode == FREELIST_PERCPU_RSEQ || mode == FREELIST_PERCPU_LOCKED) percpu_push(g_percpu, &o->node);
+    else depot_put(o);
+}
+
+// --- Benchmark Logic ---
+static void *worker(void *arg) {
+    worker_args_t *a = arg;
+    uint64_t owner = (uint64_t) a->thread_id + 1;
+    obj_t *held[MAX_BATCH];
+    for (long r = 0; r < g_rounds_per_thread; ++r) {
+        for (int i = 0; i < g_batch; ++i) {
+            held[i] = obj_alloc(a->mode, owner);
+            held[i]->payload[0] = (uint64_t) r;
+        }
+        for (int i = g_batch - 1; i >= 0; --i) {
+            obj_free(a->mode, held[i], owner);
+        }
+    }
+    return NULL;
+}
+
+static void run_benchmark(freelist_mode_t mode, int num_threads) {
+    pthread_t threads[MAX_THREADS];
+    worker_args_t args[MAX_THREADS];
+    atomic_store(&g_errors, 0);
+
+    lock_type_t depot_type = mode == FREELIST_TICKET ? LOCK_TYPE_TICKET : LOCK_TYPE_MCS;
+    if (depot_init(depot_type) != 0) {
+        fprintf(stderr, "Failed to create the depot lock for %s.\n", freelist_mode_to_string(mode));
+        return;
+    }
+    g_percpu = NULL;
+    if (mode == FREELIST_PERCPU_RSEQ || mode == FREELIST_PERCPU_LOCKED) {
+        g_percpu = percpu_create(LOCK_TYPE_MCS, mode == FREELIST_PERCPU_RSEQ ? PERCPU_MODE_RSEQ : PERCPU_MODE_LOCKED);
+        if (!g_percpu) {
+            printf("| %-14s | %3d Threads | %15s | %8s | %-8s |\n",
+                   freelist_mode_to_string(mode), num_threads, "n/a", "n/a", "SKIPPED");
+            depot_destroy();
+            return;
+        }
+    }
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    for (int i = 0; i < num_threads; ++i) {
+        args[i].mode = mode;
+        args[i].thread_id = i;
+        pthread_create(&threads[i], NULL, worker, &args[i]);
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double duration = get_time_diff(&start_time, &end_time);
+
+    long created = g_depot.created;
+    long lost = depot_destroy();
+    percpu_destroy(g_percpu);
+    g_percpu = NULL;
+
+    const char *result = (atomic_load(&g_errors) == 0 && lost == 0) ? "SUCCESS" : "FAILURE";
+    // One alloc and one free per object per round.
+    double mops = 2.0 * num_threads * g_rounds_per_thread * g_batch / duration / 1e6;
+
+    printf("| %-14s | %3d Threads | %8.3f Mops/s | %8ld | %-8s |\n",
+           freelist_mode_to_string(mode), num_threads, mops, created, result);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) g_rounds_per_thread = atol(argv[1]);
+    if (argc > 2) g_batch = atoi(argv[2]);
+    if (g_rounds_per_thread <= 0) g_rounds_per_thread = DEFAULT_ROUNDS_PER_THREAD;
+    if (g_batch <= 0 || g_batch > MAX_BATCH) g_batch = DEFAULT_BATCH;
+
+    long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_cores <= 0) num_cores = 8;
+    printf("--- C Per-CPU Freelist Benchmark ---\n");
+    printf("Detected %ld logical cores. rseq: %s. Rounds/thread: %ld, batch: %d.\n\n",
+           num_cores, percpu_register_thread() ? "available" : "unavailable", g_rounds_per_thread, g_batch);
+
+    const char *rule = "+----------------+-------------+-----------------+----------+----------+\n";
+    printf("%s", rule);
+    printf("| Freelist       | Thread Count| Throughput      | Objects  | Result   |\n");
+    printf("%s", rule);
+
+    for (int mode = FREELIST_TICKET; mode <= FREELIST_PERCPU_LOCKED; ++mode) {
+        for (int threads = 1; threads <= num_cores * 2; threads *= 2) {
+            if (threads > MAX_THREADS) break;
+            run_benchmark((freelist_mode_t) mode, threads);
+        }
+        printf("%s", rule);
+    }
+    return 0;
+}
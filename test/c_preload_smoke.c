@@ -0,0 +1,105 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Smoke test for liblock_preload.so. Plain pthread code with no liblock calls:
+// producers and consumers share a bounded queue under a statically initialized
+// mutex and two condition variables, and every thread also takes a second
+// mutex with trylock and timedlock. ctest runs it once per LIBLOCK_TYPE with
+// the shim preloaded; it must finish with every item consumed exactly once.
+//
+// Usage: c_preload_smoke [items_per_producer]
+
+#define PRODUCERS 2
+#define CONSUMERS 2
+#define QUEUE_SIZE 16
+#define DEFAULT_ITEMS 20000
+
+static pthread_mutex_t g_queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_not_empty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t g_not_full = PTHREAD_COND_INITIALIZER;
+static long g_queue[QUEUE_SIZE];
+static int g_head = 0;
+static int g_count = 0;
+static int g_producers_left = PRODUCERS;
+
+static pthread_mutex_t g_stats_lock;
+static long g_consumed_sum = 0;
+static long g_consumed = 0;
+static long g_items = DEFAULT_ITEMS;
+
+static void stats_add(long value) {
+    // Alternate the two non-blocking entry points the shim maps separately.
+    if (pthread_mutex_trylock(&g_stats_lock) != 0) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += 10;
+        if (pthread_mutex_timedlock(&g_stats_lock, &deadline) != 0) {
+            fprintf(stderr, "timedlock timed out\n");
+            exit(1);
+        }
+    }
+    g_consumed_sum += value;
+    g_consumed++;
+    pthread_mutex_unlock(&g_stats_lock);
+}
+
+static void *producer(void *arg) {
+    long base = (long) arg * g_items;
+    for (long i = 1; i <= g_items; ++i) {
+        pthread_mutex_lock(&g_queue_lock);
+        while (g_count == QUEUE_SIZE) pthread_cond_wait(&g_not_full, &g_queue_lock);
+        g_queue[(g_head + g_count) % QUEUE_SIZE] = base + i;
+        g_count++;
+        pthread_cond_signal(&g_not_empty);
+        pthread_mutex_unlock(&g_queue_lock);
+    }
+    pthread_mutex_lock(&g_queue_lock);
+    if (--g_producers_left == 0) pthread_cond_broadcast(&g_not_empty);
+    pthread_mutex_unlock(&g_queue_lock);
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    (void) arg;
+    for (;;) {
+        pthread_mutex_lock(&g_queue_lock);
+        while (g_count == 0 && g_producers_left > 0) pthread_cond_wait(&g_not_empty, &g_queue_lock);
+        if (g_count == 0) {
+            pthread_mutex_unlock(&g_queue_lock);
+            return NULL;
+        }
+        long value = g_queue[g_head];
+        g_head = (g_head + 1) % QUEUE_SIZE;
+        g_count--;
+        pthread_cond_signal(&g_not_full);
+        pthread_mutex_unlock(&g_queue_lock);
+        stats_add(value);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) g_items = atol(argv[1]);
+    if (g_items <= 0) g_items = DEFAULT_ITEMS;
+    pthread_mutex_init(&g_stats_lock, NULL);
+
+    pthread_t threads[PRODUCERS + CONSUMERS];
+    for (long i = 0; i < PRODUCERS; ++i) pthread_create(&threads[i], NULL, producer, (void *) i);
+    for (long i = 0; i < CONSUMERS; ++i) pthread_create(&threads[PRODUCERS + i], NULL, consumer, NULL);
+    for (int i = 0; i < PRODUCERS + CONSUMERS; ++i) pthread_join(threads[i], NULL);
+    pthread_mutex_destroy(&g_stats_lock);
+
+    // Producer p sends p * items + 1 .. p * items + items.
+    long expected_sum = 0;
+    for (long p = 0; p < PRODUCERS; ++p) expected_sum += p * g_items * g_items + g_items * (g_items + 1) / 2;
+    long expected = PRODUCERS * g_items;
+    if (g_consumed != expected || g_consumed_sum != expected_sum) {
+        printf("FAILURE: consumed %ld items (sum %ld), expected %ld (sum %ld)\n",
+               g_consumed, g_consumed_sum, expected, expected_sum);
+        return 1;
+    }
+    printf("SUCCESS: %ld items through %d producers and %d consumers\n", expected, PRODUCERS, CONSUMERS);
+    return 0;
+}
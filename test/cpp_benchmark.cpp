@@ -1,4 +1,8 @@
 #include <ILock.hpp> // C++ programs should prefer including the specific interface
+#include <QSpinLock.hpp>
+#include <ByteLock.hpp>
+#include <ShardedCounter.hpp>
+#include <RemoteCore.hpp>
 #include <iostream>
 #include <vector>
 #include <thread>
@@ -6,10 +10,48 @@
 #include <memory>
 #include <iomanip>
 #include <numeric>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
 
 #define MAX_THREADS 20
 // #define INCREMENTS_PER_THREAD 1000
 #define INCREMENTS_PER_THREAD 1000000
+#define SHARDED_COUNTER_BATCH 1024 // Fold threshold for the lock-free counter rows
+
+// --oversubscribe: pin up to OVERSUB_MAX_FACTOR threads per CPU and sample latency.
+#define OVERSUB_MAX_FACTOR 4
+#define OVERSUB_INCREMENTS_PER_THREAD 100000
+#define LATENCY_SAMPLE_EVERY 16
+
+// --footprint: allocate this many locks per type and report heap bytes per lock.
+#define FOOTPRINT_LOCKS 4096
+
+// --nested [depth]: re-acquire the same lock depth times around every increment.
+#define NESTED_DEFAULT_DEPTH 4
+#define NESTED_INCREMENTS_PER_THREAD 200000
+
+// --biased: one owner thread does BIASED_OWNER_OPS increments while an intruder
+// takes the lock BIASED_INTRUSIONS times, BIASED_INTRUDER_GAP_US apart.
+#define BIASED_OWNER_OPS 5000000
+#define BIASED_INTRUSIONS 200
+#define BIASED_INTRUDER_GAP_US 200
+
+// --remote-core: every critical section touches RC_LINES_TOUCHED lines of a shared
+// table, either under LOCK_TYPE_MCS or shipped to a RemoteCoreServer.
+#define RC_OPS_PER_THREAD 100000
+#define RC_TABLE_LINES 32
+#define RC_LINES_TOUCHED 4
+
+// --parking: ByteLock against MutexLock (LOCK_TYPE_PTHREAD_MUTEX), footprint and throughput.
+#define PARKING_INCREMENTS_PER_THREAD 200000
 
 // --- Shared Data ---
 long long g_shared_counter = 0;
@@ -31,6 +73,13 @@ const char* lock_type_to_string(lock_type_t type) {
         case LOCK_TYPE_TICKET:        return "Ticket Lock";
         case LOCK_TYPE_MCS:           return "MCS Lock";
         case LOCK_TYPE_CLH:           return "CLH Lock";
+        case LOCK_TYPE_MCS_TP:        return "MCS-TP Lock";
+        case LOCK_TYPE_QSPINLOCK:     return "QSpinLock";
+        case LOCK_TYPE_RECURSIVE_TICKET: return "Rec. Ticket";
+        case LOCK_TYPE_RECURSIVE_MCS:    return "Rec. MCS";
+        case LOCK_TYPE_RECURSIVE_CLH:    return "Rec. CLH";
+        case LOCK_TYPE_BIASED_TICKET:    return "Biased Ticket";
+        case LOCK_TYPE_BIASED_MCS:       return "Biased MCS";
         default:                      return "Unknown";
     }
 }
@@ -68,9 +117,456 @@ void run_benchmark(lock_type_t type, int num_threads) {
     // g_lock is automatically destroyed by unique_ptr
 }
 
-int main() {
+// --- Sharded Counter Runner ---
+// The same increment workload with no lock at all: every thread adds to its CPU's slot.
+void run_sharded_counter(unsigned int num_threads) {
+    ShardedCounter counter(SHARDED_COUNTER_BATCH);
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    for (unsigned int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&counter] {
+            for (int n = 0; n < INCREMENTS_PER_THREAD; ++n) ++counter;
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end_time - start_time;
+    long long expected = static_cast<long long>(num_threads) * INCREMENTS_PER_THREAD;
+    const char* result = (counter.readExact() == expected) ? "SUCCESS" : "FAIL";
+
+    std::cout << "| " << std::left << std::setw(13) << "Sharded Ctr"
+              << " | " << std::right << std::setw(3) << num_threads << " Threads"
+              << " | " << std::fixed << std::setprecision(4) << std::setw(8) << duration.count() << " sec"
+              << " | " << result << " |" << std::endl;
+}
+
+// --- Oversubscribed Benchmark Runner ---
+void oversub_worker(std::vector<std::uint64_t> &samples) {
+    samples.reserve(OVERSUB_INCREMENTS_PER_THREAD / LATENCY_SAMPLE_EVERY + 1);
+    for (int i = 0; i < OVERSUB_INCREMENTS_PER_THREAD; ++i) {
+        if (i % LATENCY_SAMPLE_EVERY == 0) {
+            auto t0 = std::chrono::steady_clock::now();
+            g_lock->lock();
+            g_shared_counter++;
+            g_lock->unlock();
+            auto t1 = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        } else {
+            g_lock->lock();
+            g_shared_counter++;
+            g_lock->unlock();
+        }
+    }
+}
+
+void run_oversubscribed(lock_type_t type, unsigned int num_threads, unsigned int num_cores) {
+    g_shared_counter = 0;
+    try {
+        g_lock = createLock(type);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create C++ lock: " << e.what() << std::endl;
+        return;
+    }
+
+    std::vector<std::vector<std::uint64_t> > samples(num_threads);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    for (unsigned int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(oversub_worker, std::ref(samples[i]));
+        // Round-robin pinning: num_threads / num_cores threads per CPU
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(i % num_cores, &set);
+        pthread_setaffinity_np(threads.back().native_handle(), sizeof(set), &set);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end_time - start_time;
+    long long expected = static_cast<long long>(num_threads) * OVERSUB_INCREMENTS_PER_THREAD;
+    const char* result = (g_shared_counter == expected) ? "SUCCESS" : "FAIL";
+
+    std::vector<std::uint64_t> all;
+    for (auto &s : samples) all.insert(all.end(), s.begin(), s.end());
+    std::sort(all.begin(), all.end());
+
+    std::cout << "| " << std::left << std::setw(13) << lock_type_to_string(type)
+              << " | " << std::right << std::setw(3) << num_threads << " Threads"
+              << " | " << std::fixed << std::setprecision(3) << std::setw(8) << expected / duration.count() / 1e6 << " Mops/s"
+              << " | " << std::setw(10) << all[all.size() * 99 / 100]
+              << " | " << std::setw(10) << all[all.size() * 999 / 1000]
+              << " | " << std::setw(10) << all.back()
+              << " | " << result << " |" << std::endl;
+}
+
+int run_oversubscribed_suite(unsigned int num_cores) {
+    std::cout << "--- C++ Lock Library Oversubscription Benchmark ---\n";
+    std::cout << "Pinning up to " << OVERSUB_MAX_FACTOR << " threads per CPU on " << num_cores
+              << " logical cores; latencies in ns.\n\n";
+
+    const char *rule = "+---------------+-------------+-----------------+------------+------------+------------+----------+";
+    std::cout << rule << std::endl;
+    std::cout << "| Lock Type     | Thread Count| Throughput      | p99        | p99.9      | max        | Result   |" << std::endl;
+    std::cout << rule << std::endl;
+
+    for (int type = LOCK_TYPE_PTHREAD_MUTEX; type <= LOCK_TYPE_BIASED_MCS; ++type) {
+        for (unsigned int factor = 2; factor <= OVERSUB_MAX_FACTOR; factor *= 2) {
+            run_oversubscribed(static_cast<lock_type_t>(type), num_cores * factor, num_cores);
+        }
+        std::cout << rule << std::endl;
+    }
+    return 0;
+}
+
+// Heap bytes per lock object, measured as the allocator delta over FOOTPRINT_LOCKS creations.
+int run_footprint_suite() {
+    std::cout << "--- C++ Lock Library Footprint ---\n";
+    std::cout << "Heap bytes per lock averaged over " << FOOTPRINT_LOCKS << " createLock() calls.\n\n";
+
+    const char *rule = "+---------------+-------------+-------------+";
+    std::cout << rule << std::endl;
+    std::cout << "| Lock Type     | Heap Bytes  | Embedded    |" << std::endl;
+    std::cout << rule << std::endl;
+
+    std::vector<std::unique_ptr<ILock>> locks;
+    locks.reserve(FOOTPRINT_LOCKS);
+    for (int type = LOCK_TYPE_PTHREAD_MUTEX; type <= LOCK_TYPE_BIASED_MCS; ++type) {
+        const std::size_t before = mallinfo2().uordblks;
+        for (int i = 0; i < FOOTPRINT_LOCKS; ++i) locks.push_back(createLock(static_cast<lock_type_t>(type)));
+        const std::size_t after = mallinfo2().uordblks;
+        locks.clear();
+
+        // Only the raw primitives can be embedded without the ILock wrapper.
+        std::string embedded = "-";
+        if (type == LOCK_TYPE_PTHREAD_MUTEX) embedded = std::to_string(sizeof(pthread_mutex_t));
+        if (type == LOCK_TYPE_QSPINLOCK) embedded = std::to_string(sizeof(QSpinLock));
+        std::cout << "| " << std::left << std::setw(13) << lock_type_to_string(static_cast<lock_type_t>(type))
+                  << " | " << std::right << std::setw(11) << (after - before) / FOOTPRINT_LOCKS
+                  << " | " << std::setw(11) << embedded << " |" << std::endl;
+    }
+    std::cout << rule << std::endl;
+    return 0;
+}
+
+// --- Nested Acquisition Benchmark Runner ---
+static int g_nesting_depth = NESTED_DEFAULT_DEPTH;
+
+template <typename Lockable>
+void nested_worker(Lockable &lk) {
+    for (int i = 0; i < NESTED_INCREMENTS_PER_THREAD; ++i) {
+        for (int d = 0; d < g_nesting_depth; ++d) lk.lock();
+        g_shared_counter++;
+        for (int d = 0; d < g_nesting_depth; ++d) lk.unlock();
+    }
+}
+
+template <typename Lockable>
+void run_nested(const char *name, Lockable &lk, unsigned int num_threads) {
+    g_shared_counter = 0;
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    for (unsigned int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(nested_worker<Lockable>, std::ref(lk));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end_time - start_time;
+    long long expected = static_cast<long long>(num_threads) * NESTED_INCREMENTS_PER_THREAD;
+    const char* result = (g_shared_counter == expected) ? "SUCCESS" : "FAIL";
+    double ns_per_acquire = duration.count() * 1e9 / (static_cast<double>(expected) * g_nesting_depth);
+
+    std::cout << "| " << std::left << std::setw(13) << name
+              << " | " << std::right << std::setw(3) << num_threads << " Threads"
+              << " | " << std::fixed << std::setprecision(4) << std::setw(8) << duration.count() << " sec"
+              << " | " << std::setprecision(1) << std::setw(7) << ns_per_acquire << " ns"
+              << " | " << result << " |" << std::endl;
+}
+
+int run_nested_suite(unsigned int num_cores) {
+    std::cout << "--- C++ Lock Library Nested Acquisition Benchmark ---\n";
+    std::cout << "Each increment acquires the same lock " << g_nesting_depth
+              << " times; ns/acquire averages over all of them.\n\n";
+
+    const char *rule = "+---------------+-------------+------------+------------+----------+";
+    std::cout << rule << std::endl;
+    std::cout << "| Lock Type     | Thread Count| Duration   | ns/acquire | Result   |" << std::endl;
+    std::cout << rule << std::endl;
+
+    for (unsigned int threads = 1; threads <= num_cores * 2 && threads <= MAX_THREADS; threads *= 2) {
+        std::recursive_mutex baseline;
+        run_nested("std::rec_mtx", baseline, threads);
+    }
+    std::cout << rule << std::endl;
+
+    for (int type = LOCK_TYPE_RECURSIVE_TICKET; type <= LOCK_TYPE_RECURSIVE_CLH; ++type) {
+        for (unsigned int threads = 1; threads <= num_cores * 2 && threads <= MAX_THREADS; threads *= 2) {
+            std::unique_ptr<ILock> lk;
+            try {
+                lk = createLock(static_cast<lock_type_t>(type));
+            } catch (const std::exception& e) {
+                std::cerr << "Failed to create C++ lock: " << e.what() << std::endl;
+                return 1;
+            }
+            run_nested(lock_type_to_string(static_cast<lock_type_t>(type)), *lk, threads);
+        }
+        std::cout << rule << std::endl;
+    }
+    return 0;
+}
+
+// --- Biased Lock Benchmark Runner ---
+double biased_owner() {
+    auto start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < BIASED_OWNER_OPS; ++i) {
+        g_lock->lock();
+        g_shared_counter++;
+        g_lock->unlock();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start_time;
+    return elapsed.count() / BIASED_OWNER_OPS;
+}
+
+double biased_intruder() {
+    std::chrono::duration<double, std::nano> total{0};
+    for (int i = 0; i < BIASED_INTRUSIONS; ++i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(BIASED_INTRUDER_GAP_US));
+        auto t0 = std::chrono::steady_clock::now();
+        g_lock->lock();
+        total += std::chrono::steady_clock::now() - t0;
+        g_shared_counter++;
+        g_lock->unlock();
+    }
+    return total.count() / BIASED_INTRUSIONS;
+}
+
+void run_biased(lock_type_t type) {
+    double alone = 0, shared = 0, intruder_acquire = 0;
+    try {
+        // Owner alone: the single-owner fast path.
+        g_shared_counter = 0;
+        g_lock = createLock(type);
+        std::thread([&] { alone = biased_owner(); }).join();
+        bool ok = g_shared_counter == BIASED_OWNER_OPS;
+
+        // Owner plus an occasional intruder: every intrusion may revoke the bias.
+        g_shared_counter = 0;
+        g_lock = createLock(type);
+        std::thread owner([&] { shared = biased_owner(); });
+        std::thread intruder([&] { intruder_acquire = biased_intruder(); });
+        owner.join();
+        intruder.join();
+        ok = ok && g_shared_counter == BIASED_OWNER_OPS + BIASED_INTRUSIONS;
+
+        std::cout << "| " << std::left << std::setw(13) << lock_type_to_string(type)
+                  << " | " << std::right << std::fixed << std::setprecision(2) << std::setw(8) << alone << " ns"
+                  << " | " << std::setw(8) << shared << " ns"
+                  << " | " << std::setprecision(0) << std::setw(9) << intruder_acquire << " ns"
+                  << " | " << std::setw(11) << biasRevocations(*g_lock)
+                  << " | " << (ok ? "SUCCESS" : "FAIL") << " |" << std::endl;
+        g_lock.reset();
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create C++ lock: " << e.what() << std::endl;
+    }
+}
+
+int run_biased_suite() {
+    std::cout << "--- C++ Lock Library Biased Locking Benchmark ---\n";
+    std::cout << "Owner does " << BIASED_OWNER_OPS << " increments; the intruder takes the lock "
+              << BIASED_INTRUSIONS << " times, " << BIASED_INTRUDER_GAP_US << " us apart.\n\n";
+
+    const char *rule = "+---------------+-------------+-------------+--------------+-------------+----------+";
+    std::cout << rule << std::endl;
+    std::cout << "| Lock Type     | Owner alone | w/ intruder | Intruder acq | Revocations | Result   |" << std::endl;
+    std::cout << rule << std::endl;
+    const lock_type_t types[] = {
+        LOCK_TYPE_PTHREAD_MUTEX, LOCK_TYPE_TICKET, LOCK_TYPE_BIASED_TICKET, LOCK_TYPE_MCS, LOCK_TYPE_BIASED_MCS
+    };
+    for (lock_type_t type : types) {
+        run_biased(type);
+    }
+    std::cout << rule << std::endl;
+    return 0;
+}
+
+// --- Remote Core Locking Benchmark Runner ---
+alignas(64) std::uint64_t g_rc_table[RC_TABLE_LINES][8];
+std::unique_ptr<RemoteCoreServer> g_rcl;
+
+inline void rc_critical_section(std::uintptr_t seed) {
+    for (int i = 0; i < RC_LINES_TOUCHED; ++i) {
+        g_rc_table[(seed + i * 7) % RC_TABLE_LINES][i]++;
+    }
+    g_shared_counter++;
+}
+
+void rc_worker(std::uintptr_t seed) {
+    for (int i = 0; i < RC_OPS_PER_THREAD; ++i, seed += 13) {
+        if (g_rcl) {
+            g_rcl->execute([seed] { rc_critical_section(seed); });
+        } else {
+            g_lock->lock();
+            rc_critical_section(seed);
+            g_lock->unlock();
+        }
+    }
+}
+
+void run_remote_core(const char *name, unsigned int num_threads) {
+    g_shared_counter = 0;
+    std::memset(g_rc_table, 0, sizeof(g_rc_table));
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(rc_worker, i);
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start_time;
+
+    const long long expected = static_cast<long long>(num_threads) * RC_OPS_PER_THREAD;
+    std::cout << "| " << std::left << std::setw(13) << name
+              << " | " << std::right << std::setw(3) << num_threads << " Threads"
+              << " | " << std::fixed << std::setprecision(3) << std::setw(8) << expected / duration.count() / 1e6
+              << " Mops/s | " << std::left << std::setw(8) << (g_shared_counter == expected ? "SUCCESS" : "FAIL")
+              << " |" << std::endl;
+}
+
+int run_remote_core_suite(unsigned int num_cores) {
+    std::cout << "--- C++ Lock Library Remote Core Locking Benchmark ---\n";
+    std::cout << "Detected " << num_cores << " logical cores. Each critical section touches " << RC_LINES_TOUCHED
+              << " of " << RC_TABLE_LINES << " cache lines.\n";
+    // Keep the server on its own core when there is one to spare.
+    const int server_cpu = num_cores > 1 ? static_cast<int>(num_cores) - 1 : -1;
+    std::cout << "Server thread pinned to CPU " << server_cpu << " (-1: unpinned).\n\n";
+
+    const char *rule = "+---------------+-------------+-----------------+----------+";
+    std::cout << rule << std::endl;
+    std::cout << "| Engine        | Thread Count| Throughput      | Result   |" << std::endl;
+    std::cout << rule << std::endl;
+
+    for (unsigned int threads = 2; threads <= MAX_THREADS; threads *= 2) {
+        try {
+            g_lock = createLock(LOCK_TYPE_MCS);
+            run_remote_core(lock_type_to_string(LOCK_TYPE_MCS), threads);
+            g_lock.reset();
+
+            g_rcl = std::make_unique<RemoteCoreServer>(server_cpu, RemoteCoreServer::Idle::Poll);
+            run_remote_core("RCL (polling)", threads);
+            g_rcl = std::make_unique<RemoteCoreServer>(server_cpu, RemoteCoreServer::Idle::Park);
+            run_remote_core("RCL (parking)", threads);
+            g_rcl.reset();
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to set up remote core benchmark: " << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << rule << std::endl;
+    }
+    return 0;
+}
+
+// --- Parking Lot Benchmark Runner ---
+template <typename Lockable>
+void run_parking(const char *name, Lockable &lk, std::size_t embedded, std::size_t heap, unsigned int num_threads) {
+    g_shared_counter = 0;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&lk] {
+            for (int n = 0; n < PARKING_INCREMENTS_PER_THREAD; ++n) {
+                lk.lock();
+                g_shared_counter++;
+                lk.unlock();
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start_time;
+
+    const long long expected = static_cast<long long>(num_threads) * PARKING_INCREMENTS_PER_THREAD;
+    std::cout << "| " << std::left << std::setw(13) << name
+              << " | " << std::right << std::setw(8) << embedded
+              << " | " << std::setw(10) << heap
+              << " | " << std::setw(3) << num_threads << " Threads"
+              << " | " << std::fixed << std::setprecision(3) << std::setw(8) << expected / duration.count() / 1e6
+              << " Mops/s | " << std::left << std::setw(8) << (g_shared_counter == expected ? "SUCCESS" : "FAIL")
+              << " |" << std::endl;
+}
+
+int run_parking_suite() {
+    std::cout << "--- C++ Lock Library Parking Lot Benchmark ---\n";
+    std::cout << "Embedded: bytes inside the protected object. Heap: bytes per createLock() call.\n\n";
+
+    // Heap bytes behind one MutexLock, as in --footprint.
+    std::vector<std::unique_ptr<ILock>> locks;
+    locks.reserve(FOOTPRINT_LOCKS);
+    const std::size_t before = mallinfo2().uordblks;
+    for (int i = 0; i < FOOTPRINT_LOCKS; ++i) locks.push_back(createLock(LOCK_TYPE_PTHREAD_MUTEX));
+    const std::size_t mutex_heap = (mallinfo2().uordblks - before) / FOOTPRINT_LOCKS;
+    locks.clear();
+
+    const char *rule = "+---------------+----------+------------+-------------+-----------------+----------+";
+    std::cout << rule << std::endl;
+    std::cout << "| Lock Type     | Embedded | Heap Bytes | Thread Count| Throughput      | Result   |" << std::endl;
+    std::cout << rule << std::endl;
+    for (unsigned int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        try {
+            ByteLock byte_lock;
+            run_parking("Byte Lock", byte_lock, sizeof(ByteLock), 0, threads);
+            std::unique_ptr<ILock> mutex_lock = createLock(LOCK_TYPE_PTHREAD_MUTEX);
+            run_parking(lock_type_to_string(LOCK_TYPE_PTHREAD_MUTEX), *mutex_lock, sizeof(std::unique_ptr<ILock>),
+                        mutex_heap, threads);
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to create C++ lock: " << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << rule << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
     unsigned int num_cores = std::thread::hardware_concurrency();
     if (num_cores == 0) num_cores = 8;
+    if (argc > 1 && std::strcmp(argv[1], "--oversubscribe") == 0) {
+        return run_oversubscribed_suite(num_cores);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--footprint") == 0) {
+        return run_footprint_suite();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--biased") == 0) {
+        return run_biased_suite();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--parking") == 0) {
+        return run_parking_suite();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--remote-core") == 0) {
+        return run_remote_core_suite(num_cores);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--nested") == 0) {
+        if (argc > 2) g_nesting_depth = std::atoi(argv[2]);
+        if (g_nesting_depth <= 0) g_nesting_depth = NESTED_DEFAULT_DEPTH;
+        return run_nested_suite(num_cores);
+    }
     std::cout << "--- C++ Lock Library Benchmark ---\n";
     std::cout << "Detected " << num_cores << " logical cores.\n\n";
 
@@ -78,12 +574,17 @@ int main() {
     std::cout << "| Lock Type     | Thread Count| Duration   | Result   |" << std::endl;
     std::cout << "+---------------+-------------+------------+----------+" << std::endl;
 
-    for (int type = LOCK_TYPE_PTHREAD_MUTEX; type <= LOCK_TYPE_CLH; ++type) {
+    for (int type = LOCK_TYPE_PTHREAD_MUTEX; type <= LOCK_TYPE_BIASED_MCS; ++type) {
         for (unsigned int threads = 1; threads <= num_cores * 2; threads *= 2) {
              if (threads > MAX_THREADS) break;
              run_benchmark(static_cast<lock_type_t>(type), threads);
         }
         std::cout << "+---------------+-------------+------------+----------+" << std::endl;
     }
+    for (unsigned int threads = 1; threads <= num_cores * 2; threads *= 2) {
+        if (threads > MAX_THREADS) break;
+        run_sharded_counter(threads);
+    }
+    std::cout << "+---------------+-------------+------------+----------+" << std::endl;
     return 0;
 }
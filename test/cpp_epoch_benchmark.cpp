@@ -0,0 +1,243 @@
+#include <ILock.hpp> // C++ programs should prefer including the specific interface
+#include <Epoch.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Read-mostly chained hash table. Readers either take the bucket's MCS lock or
+// run lock-free inside an Epoch::Guard; in the latter case writers still
+// serialize on the bucket lock, replace nodes copy-on-write and retire the old
+// version through the epoch reclaimer.
+//
+// Usage: cpp_epoch_benchmark [buckets] [ops_per_thread]
+
+#define MAX_THREADS 20
+#define DEFAULT_BUCKETS 1024
+#define DEFAULT_OPS_PER_THREAD 1000000
+#define KEY_SPACE 4096
+
+enum class ReadMode { Locked, Epoch };
+
+static constexpr std::uint64_t kNodeMagic = 0x5EEDF00DCAFEBABEull;
+static constexpr std::uint64_t kNodePoison = 0xDEADDEADDEADDEADull;
+
+static int g_buckets = DEFAULT_BUCKETS;
+static long g_ops_per_thread = DEFAULT_OPS_PER_THREAD;
+static std::atomic<long> g_errors{0};
+static std::atomic<long> g_retired{0};
+static std::atomic<long> g_freed{0};
+
+// --- Utility Functions ---
+const char *read_mode_to_string(ReadMode mode) {
+    return mode == ReadMode::Locked ? "MCS Lock" : "Epoch";
+}
+
+static inline std::uint64_t xorshift64(std::uint64_t &state) {
+    std::uint64_t x = state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return state = x;
+}
+
+// --- Table ---
+struct Node {
+    Node(std::uint64_t k, std::uint64_t v, Node *n) : key(k), value(v), check(k ^ v ^ kNodeMagic), next(n) {}
+
+    ~Node() {
+        // A reader that still sees this node after reclamation will trip over the poison.
+        check = kNodePoison;
+    }
+
+    std::uint64_t key;
+    std::uint64_t value;
+    std::uint64_t check; // key ^ value ^ kNodeMagic
+    std::atomic<Node *> next;
+};
+
+struct alignas(64) Bucket {
+    std::unique_ptr<ILock> lock = createLock(LOCK_TYPE_MCS);
+    std::atomic<Node *> head{nullptr};
+};
+
+class Table {
+public:
+    Table() : _buckets(g_buckets) {
+        for (std::uint64_t k = 0; k < KEY_SPACE; ++k) {
+            Bucket &b = bucket(k);
+            b.head.store(new Node(k, k, b.head.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+        }
+    }
+
+    ~Table() {
+        for (Bucket &b: _buckets) {
+            for (Node *n = b.head.load(std::memory_order_relaxed); n;) {
+                Node *next = n->next.load(std::memory_order_relaxed);
+                delete n;
+                n = next;
+            }
+        }
+    }
+
+    // Number of keys present, which must stay KEY_SPACE.
+    long size() const {
+        long keys = 0;
+        for (const Bucket &b: _buckets) {
+            for (Node *n = b.head.load(std::memory_order_relaxed); n; n = n->next.load(std::memory_order_relaxed)) {
+                ++keys;
+            }
+        }
+        return keys;
+    }
+
+    std::uint64_t get(ReadMode mode, std::uint64_t key) {
+        Bucket &b = bucket(key);
+        if (mode == ReadMode::Locked) {
+            b.lock->lock();
+            std::uint64_t value = find(b, key);
+            b.lock->unlock();
+            return value;
+        }
+        Epoch::Guard guard;
+        return find(b, key);
+    }
+
+    void update(ReadMode mode, std::uint64_t key, std::uint64_t value) {
+        Bucket &b = bucket(key);
+        Node *old = nullptr;
+        b.lock->lock();
+        std::atomic<Node *> *link = &b.head;
+        for (Node *n = link->load(std::memory_order_relaxed); n; link = &n->next, n = link->load(std::memory_order_relaxed)) {
+            if (n->key != key) continue;
+            if (mode == ReadMode::Locked) {
+                n->value = value;
+                n->check = key ^ value ^ kNodeMagic;
+            } else {
+                // Lock-free readers may be looking at n: publish a fresh copy instead.
+                old = n;
+                link->store(new Node(key, value, n->next.load(std::memory_order_relaxed)), std::memory_order_release);
+            }
+            break;
+        }
+        b.lock->unlock();
+        if (old) {
+            g_retired.fetch_add(1, std::memory_order_relaxed);
+            Epoch::retire(old, freeNode);
+        }
+    }
+
+private:
+    static void freeNode(void *ptr) {
+        g_freed.fetch_add(1, std::memory_order_relaxed);
+        delete static_cast<Node *>(ptr);
+    }
+
+    Bucket &bucket(std::uint64_t key) {
+        return _buckets[(key * 0x9E3779B97F4A7C15ull >> 32) % _buckets.size()];
+    }
+
+    static std::uint64_t find(Bucket &b, std::uint64_t key) {
+        for (Node *n = b.head.load(std::memory_order_acquire); n; n = n->next.load(std::memory_order_acquire)) {
+            if (n->key != key) continue;
+            if (n->check != (n->key ^ n->value ^ kNodeMagic)) g_errors.fetch_add(1, std::memory_order_relaxed);
+            return n->value;
+        }
+        return 0;
+    }
+
+    std::vector<Bucket> _buckets;
+};
+
+// --- Benchmark Logic ---
+void run_benchmark(ReadMode mode, unsigned write_permille, unsigned int num_threads) {
+    g_errors = 0;
+    g_retired = 0;
+    g_freed = 0;
+    std::unique_ptr<Table> table;
+    try {
+        table = std::make_unique<Table>();
+    } catch (const std::exception &e) {
+        std::cerr << "Failed to create C++ lock: " << e.what() << std::endl;
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    std::atomic<std::uint64_t> sink{0};
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            std::uint64_t rng = 0x2545F4914F6CDD1Dull ^ (static_cast<std::uint64_t>(t + 1) * 0x9E3779B97F4A7C15ull);
+            std::uint64_t local = 0;
+            for (long i = 0; i < g_ops_per_thread; ++i) {
+                const std::uint64_t r = xorshift64(rng);
+                const std::uint64_t key = r % KEY_SPACE;
+                if ((r >> 32) % 1000 < write_permille) table->update(mode, key, r);
+                else local += table->get(mode, key);
+            }
+            sink.fetch_add(local, std::memory_order_relaxed);
+        });
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end_time - start_time;
+
+    // Exited workers left their pending retirees behind; two grace periods free them all.
+    for (int i = 0; i < 1000 && g_freed.load() < g_retired.load(); ++i) {
+        Epoch::reclaim();
+        std::this_thread::yield();
+    }
+
+    const long leaked = g_retired.load() - g_freed.load();
+    const long keys = table->size();
+    const char *result = (g_errors.load() == 0 && leaked == 0 && keys == KEY_SPACE) ? "SUCCESS" : "FAILURE";
+    double mops = static_cast<double>(num_threads) * g_ops_per_thread / duration.count() / 1e6;
+
+    std::cout << "| " << std::left << std::setw(9) << read_mode_to_string(mode)
+              << " | " << std::right << std::fixed << std::setprecision(1) << std::setw(5) << write_permille / 10.0 << "%"
+              << " | " << std::setw(3) << num_threads << " Threads"
+              << " | " << std::setprecision(3) << std::setw(8) << mops << " Mops/s"
+              << " | " << std::setw(10) << g_retired.load()
+              << " | " << std::left << std::setw(8) << result << " |" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) g_buckets = std::atoi(argv[1]);
+    if (argc > 2) g_ops_per_thread = std::atol(argv[2]);
+    if (g_buckets <= 0) g_buckets = DEFAULT_BUCKETS;
+    if (g_ops_per_thread <= 0) g_ops_per_thread = DEFAULT_OPS_PER_THREAD;
+
+    unsigned int num_cores = std::thread::hardware_concurrency();
+    if (num_cores == 0) num_cores = 8;
+    std::cout << "--- C++ Epoch Reclamation Benchmark ---\n";
+    std::cout << "Detected " << num_cores << " logical cores. Buckets: " << g_buckets << ", keys: " << KEY_SPACE
+              << ", ops/thread: " << g_ops_per_thread << ".\n\n";
+
+    const char *rule = "+-----------+--------+-------------+-----------------+------------+----------+";
+    std::cout << rule << std::endl;
+    std::cout << "| Reads via | Writes | Thread Count| Throughput      | Retired    | Result   |" << std::endl;
+    std::cout << rule << std::endl;
+
+    const unsigned write_permilles[] = {0, 10, 100};
+    const ReadMode modes[] = {ReadMode::Locked, ReadMode::Epoch};
+    for (unsigned write_permille: write_permilles) {
+        for (ReadMode mode: modes) {
+            for (unsigned int threads = 1; threads <= num_cores * 2; threads *= 2) {
+                if (threads > MAX_THREADS) break;
+                run_benchmark(mode, write_permille, threads);
+            }
+        }
+        std::cout << rule << std::endl;
+    }
+    return 0;
+}
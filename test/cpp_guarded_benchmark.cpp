@@ -0,0 +1,179 @@
+#include <ILock.hpp> // C++ programs should prefer including the specific interface
+#include <Guarded.hpp>
+#include <QSpinLock.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Guarded layout benchmark. Each thread updates randomly chosen Guarded
+// records; the number of records sets the contention level (one record means
+// every thread fights over the same lock). Every lock runs once with the data
+// sharing the lock's cache line and once with the data on its own line. The
+// factory types hold their ILock by pointer; QSpinLock and std::mutex are
+// embedded, so with LayoutSharedLine the lock word itself shares the data's line.
+// Only the embedded locks get a winner: for the factory types the layout moves
+// the pointer, not the lock state.
+//
+// Usage: cpp_guarded_benchmark [ops_per_thread]
+
+#define MAX_THREADS 20
+#define DEFAULT_OPS_PER_THREAD 200000
+#define MAX_RECORDS 64
+#define OUTSIDE_WORK 32 // Non-critical iterations between acquisitions
+
+struct Record {
+    std::uint64_t hits = 0;
+    std::uint64_t total = 0;
+    std::uint64_t last = 0;
+    std::uint64_t check = 0; // hits ^ total ^ last; a torn update breaks it
+};
+
+static long g_ops_per_thread = DEFAULT_OPS_PER_THREAD;
+
+// --- Utility Functions ---
+const char* lock_type_to_string(lock_type_t type) {
+    switch (type) {
+        case LOCK_TYPE_PTHREAD_MUTEX: return "std::mutex";
+        case LOCK_TYPE_TICKET:        return "Ticket Lock";
+        case LOCK_TYPE_MCS:           return "MCS Lock";
+        case LOCK_TYPE_CLH:           return "CLH Lock";
+        case LOCK_TYPE_MCS_TP:        return "MCS-TP Lock";
+        case LOCK_TYPE_QSPINLOCK:     return "QSpinLock";
+        case LOCK_TYPE_RECURSIVE_TICKET: return "Rec. Ticket";
+        case LOCK_TYPE_RECURSIVE_MCS:    return "Rec. MCS";
+        case LOCK_TYPE_RECURSIVE_CLH:    return "Rec. CLH";
+        case LOCK_TYPE_BIASED_TICKET:    return "Biased Ticket";
+        case LOCK_TYPE_BIASED_MCS:       return "Biased MCS";
+        default:                      return "Unknown";
+    }
+}
+
+static inline std::uint64_t xorshift64(std::uint64_t &state) {
+    std::uint64_t x = state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return state = x;
+}
+
+// --- Benchmark Logic ---
+// Returns throughput in Mops/s, or a negative value if the run failed.
+template <typename LockPolicy, typename Layout>
+double run_layout(int num_records, unsigned int num_threads) {
+    using Slot = Guarded<Record, LockPolicy, Layout>;
+    static_assert(sizeof(Slot) % 64 == 0, "Guarded must own whole cache lines");
+
+    std::vector<std::unique_ptr<Slot> > records;
+    for (int i = 0; i < num_records; ++i) records.push_back(std::make_unique<Slot>());
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::atomic<std::uint64_t> sink{0};
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&records, &sink, num_records, t] {
+            std::uint64_t rng = 0x2545F4914F6CDD1Dull ^ ((t + 1) * 0x9E3779B97F4A7C15ull);
+            std::uint64_t local = 0;
+            for (long i = 0; i < g_ops_per_thread; ++i) {
+                const std::uint64_t value = xorshift64(rng);
+                records[value % static_cast<std::uint64_t>(num_records)]->with_lock([value](Record &r) {
+                    r.hits++;
+                    r.total += value >> 32;
+                    r.last = value >> 32;
+                    r.check = r.hits ^ r.total ^ r.last;
+                });
+                for (int w = 0; w < OUTSIDE_WORK; ++w) local += xorshift64(rng);
+            }
+            sink.fetch_add(local, std::memory_order_relaxed);
+        });
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end_time - start_time;
+
+    bool ok = true;
+    std::uint64_t hits = 0;
+    for (auto &slot: records) {
+        auto r = slot->read();
+        if (r->check != (r->hits ^ r->total ^ r->last)) ok = false;
+        hits += r->hits;
+    }
+    if (!ok || hits != static_cast<std::uint64_t>(num_threads) * g_ops_per_thread) return -1.0;
+    return static_cast<double>(num_threads) * g_ops_per_thread / duration.count() / 1e6;
+}
+
+template <typename LockPolicy>
+struct HoldsLockByPointer : std::false_type {};
+
+template <lock_type_t Type>
+struct HoldsLockByPointer<FactoryLock<Type> > : std::true_type {};
+
+template <typename LockPolicy>
+void run_benchmark(const char *name, int num_records, unsigned int num_threads) {
+    const double shared = run_layout<LockPolicy, LayoutSharedLine>(num_records, num_threads);
+    const double separate = run_layout<LockPolicy, LayoutSeparateLines>(num_records, num_threads);
+    const char *result = (shared >= 0 && separate >= 0) ? "SUCCESS" : "FAILURE";
+    const char *winner = HoldsLockByPointer<LockPolicy>::value ? "-" : shared >= separate ? "Shared" : "Separate";
+
+    std::cout << "| " << std::left << std::setw(19) << name
+              << " | " << std::right << std::setw(7) << num_records
+              << " | " << std::setw(3) << num_threads << " Threads"
+              << " | " << std::fixed << std::setprecision(3) << std::setw(8) << shared << " Mops/s"
+              << " | " << std::setw(8) << separate << " Mops/s"
+              << " | " << std::left << std::setw(8) << winner
+              << " | " << std::setw(8) << result << " |" << std::endl;
+}
+
+template <typename LockPolicy>
+void run_thread_sweep(const char *name, int num_records, unsigned int num_cores) {
+    for (unsigned int threads = 1; threads <= num_cores * 2; threads *= 2) {
+        if (threads > MAX_THREADS) break;
+        run_benchmark<LockPolicy>(name, num_records, threads);
+    }
+}
+
+template <int... Types>
+void run_factory_types(int num_records, unsigned int num_cores, std::integer_sequence<int, Types...>) {
+    (run_thread_sweep<FactoryLock<static_cast<lock_type_t>(Types)> >(
+         lock_type_to_string(static_cast<lock_type_t>(Types)), num_records, num_cores), ...);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) g_ops_per_thread = std::atol(argv[1]);
+    if (g_ops_per_thread <= 0) g_ops_per_thread = DEFAULT_OPS_PER_THREAD;
+
+    unsigned int num_cores = std::thread::hardware_concurrency();
+    if (num_cores == 0) num_cores = 8;
+    std::cout << "--- C++ Guarded Layout Benchmark ---\n";
+    std::cout << "Detected " << num_cores << " logical cores. Ops/thread: " << g_ops_per_thread
+              << ", outside work: " << OUTSIDE_WORK << " iterations.\n\n";
+
+    const char *rule =
+        "+---------------------+---------+-------------+-----------------+-----------------+----------+----------+";
+    std::cout << rule << std::endl;
+    std::cout << "| Lock                | Records | Thread Count| Shared Line     | Separate Lines  | Winner   | Result   |"
+              << std::endl;
+    std::cout << rule << std::endl;
+
+    // One record is full contention; more records spread the threads out.
+    const int record_counts[] = {1, 8, MAX_RECORDS};
+    for (int num_records: record_counts) {
+        run_factory_types(num_records, num_cores, std::make_integer_sequence<int, LOCK_TYPE_BIASED_MCS + 1>{});
+        run_thread_sweep<QSpinLock>("QSpinLock (inline)", num_records, num_cores);
+        run_thread_sweep<std::mutex>("std::mutex (inline)", num_records, num_cores);
+        std::cout << rule << std::endl;
+    }
+    return 0;
+}
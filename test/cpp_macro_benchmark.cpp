@@ -0,0 +1,338 @@
+#include <ILock.hpp> // C++ programs should prefer including the specific interface
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Application-level workloads built on ILock: a sharded hash map, a bounded
+// MPMC queue and an LRU cache. Each one is run over every lock type and
+// reports throughput plus sampled per-operation tail latency.
+//
+// Usage: cpp_macro_benchmark [buckets] [ops_per_thread]
+
+#define MAX_THREADS 20
+#define DEFAULT_BUCKETS 1024
+#define DEFAULT_OPS_PER_THREAD 200000
+#define LATENCY_SAMPLE_EVERY 16
+#define KEY_SPACE 16384
+#define QUEUE_CAPACITY 1024
+#define LRU_CAPACITY 4096
+
+enum class Workload { HashMap, Queue, LruReadMostly, LruMixed };
+
+static int g_buckets = DEFAULT_BUCKETS;
+static long g_ops_per_thread = DEFAULT_OPS_PER_THREAD;
+
+// --- Utility Functions ---
+const char *lock_type_to_string(lock_type_t type) {
+    switch (type) {
+        case LOCK_TYPE_PTHREAD_MUTEX: return "std::mutex";
+        case LOCK_TYPE_TICKET:        return "Ticket Lock";
+        case LOCK_TYPE_MCS:           return "MCS Lock";
+        case LOCK_TYPE_CLH:           return "CLH Lock";
+        case LOCK_TYPE_MCS_TP:        return "MCS-TP Lock";
+        case LOCK_TYPE_QSPINLOCK:     return "QSpinLock";
+        case LOCK_TYPE_RECURSIVE_TICKET: return "Rec. Ticket";
+        case LOCK_TYPE_RECURSIVE_MCS:    return "Rec. MCS";
+        case LOCK_TYPE_RECURSIVE_CLH:    return "Rec. CLH";
+        case LOCK_TYPE_BIASED_TICKET:    return "Biased Ticket";
+        case LOCK_TYPE_BIASED_MCS:       return "Biased MCS";
+        default:                      return "Unknown";
+    }
+}
+
+const char *workload_to_string(Workload w) {
+    switch (w) {
+        case Workload::HashMap:       return "Hash Map";
+        case Workload::Queue:         return "MPMC Queue";
+        case Workload::LruReadMostly: return "LRU 90/10";
+        case Workload::LruMixed:      return "LRU 50/50";
+    }
+    return "Unknown";
+}
+
+static inline std::uint64_t xorshift64(std::uint64_t &state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Adapts ILock to std::lock_guard without exposing the lock type to the workloads.
+class LockRef {
+public:
+    explicit LockRef(ILock &lock) : _lock(lock) {
+    }
+
+    void lock() { _lock.lock(); }
+    void unlock() { _lock.unlock(); }
+
+private:
+    ILock &_lock;
+};
+
+// --- Sharded Hash Map ---
+class ShardedHashMap {
+public:
+    ShardedHashMap(lock_type_t type, int num_buckets) : _buckets(num_buckets) {
+        for (auto &b: _buckets) b.lock = createLock(type);
+    }
+
+    bool get(std::uint64_t key, std::uint64_t &value) {
+        Bucket &b = bucketFor(key);
+        LockRef ref(*b.lock);
+        std::lock_guard<LockRef> guard(ref);
+        auto it = b.map.find(key);
+        if (it == b.map.end()) return false;
+        value = it->second;
+        return true;
+    }
+
+    void put(std::uint64_t key, std::uint64_t value) {
+        Bucket &b = bucketFor(key);
+        LockRef ref(*b.lock);
+        std::lock_guard<LockRef> guard(ref);
+        b.map[key] = value;
+    }
+
+    void erase(std::uint64_t key) {
+        Bucket &b = bucketFor(key);
+        LockRef ref(*b.lock);
+        std::lock_guard<LockRef> guard(ref);
+        b.map.erase(key);
+    }
+
+private:
+    struct alignas(64) Bucket {
+        std::unique_ptr<ILock> lock;
+        std::unordered_map<std::uint64_t, std::uint64_t> map;
+    };
+
+    Bucket &bucketFor(std::uint64_t key) {
+        return _buckets[(key * 0x9E3779B97F4A7C15ull >> 32) % _buckets.size()];
+    }
+
+    std::vector<Bucket> _buckets;
+};
+
+// --- Bounded MPMC Queue ---
+class BoundedQueue {
+public:
+    explicit BoundedQueue(lock_type_t type) : _lock(createLock(type)) {
+    }
+
+    bool tryPush(std::uint64_t v) {
+        LockRef ref(*_lock);
+        std::lock_guard<LockRef> guard(ref);
+        if (_count == QUEUE_CAPACITY) return false;
+        _slots[_tail] = v;
+        _tail = (_tail + 1) % QUEUE_CAPACITY;
+        ++_count;
+        return true;
+    }
+
+    bool tryPop(std::uint64_t &v) {
+        LockRef ref(*_lock);
+        std::lock_guard<LockRef> guard(ref);
+        if (_count == 0) return false;
+        v = _slots[_head];
+        _head = (_head + 1) % QUEUE_CAPACITY;
+        --_count;
+        return true;
+    }
+
+private:
+    std::unique_ptr<ILock> _lock;
+    std::uint64_t _slots[QUEUE_CAPACITY] = {};
+    std::size_t _head = 0;
+    std::size_t _tail = 0;
+    std::size_t _count = 0;
+};
+
+// --- LRU Cache ---
+class LruCache {
+public:
+    explicit LruCache(lock_type_t type) : _lock(createLock(type)) {
+        _index.reserve(LRU_CAPACITY * 2);
+    }
+
+    bool get(std::uint64_t key, std::uint64_t &value) {
+        LockRef ref(*_lock);
+        std::lock_guard<LockRef> guard(ref);
+        auto it = _index.find(key);
+        if (it == _index.end()) return false;
+        _order.splice(_order.begin(), _order, it->second);
+        value = it->second->second;
+        return true;
+    }
+
+    void put(std::uint64_t key, std::uint64_t value) {
+        LockRef ref(*_lock);
+        std::lock_guard<LockRef> guard(ref);
+        auto it = _index.find(key);
+        if (it != _index.end()) {
+            it->second->second = value;
+            _order.splice(_order.begin(), _order, it->second);
+            return;
+        }
+        if (_index.size() == LRU_CAPACITY) {
+            // Recycle the least recently used node instead of reallocating.
+            auto victim = std::prev(_order.end());
+            _index.erase(victim->first);
+            victim->first = key;
+            victim->second = value;
+            _order.splice(_order.begin(), _order, victim);
+        } else {
+            _order.emplace_front(key, value);
+        }
+        _index[key] = _order.begin();
+    }
+
+private:
+    std::unique_ptr<ILock> _lock;
+    std::list<std::pair<std::uint64_t, std::uint64_t> > _order;
+    std::unordered_map<std::uint64_t, std::list<std::pair<std::uint64_t, std::uint64_t> >::iterator> _index;
+};
+
+// --- Benchmark Runner ---
+struct Workloads {
+    std::unique_ptr<ShardedHashMap> map;
+    std::unique_ptr<BoundedQueue> queue;
+    std::unique_ptr<LruCache> lru;
+};
+
+static inline void run_one_op(Workload workload, Workloads &w, std::uint64_t &rng, long i) {
+    std::uint64_t r = xorshift64(rng);
+    std::uint64_t key = r % KEY_SPACE;
+    std::uint64_t value;
+    switch (workload) {
+        case Workload::HashMap: {
+            unsigned pct = static_cast<unsigned>(r >> 40) % 100;
+            if (pct < 80) w.map->get(key, value);
+            else if (pct < 90) w.map->put(key, r);
+            else w.map->erase(key);
+            break;
+        }
+        case Workload::Queue:
+            if (i & 1) w.queue->tryPop(value);
+            else w.queue->tryPush(r);
+            break;
+        case Workload::LruReadMostly:
+        case Workload::LruMixed: {
+            unsigned read_pct = (workload == Workload::LruReadMostly) ? 90 : 50;
+            // Skew keys towards a hot set so the cache sees realistic hit rates.
+            key = ((r >> 40) % 100 < 80) ? key % (LRU_CAPACITY / 2) : key;
+            if (static_cast<unsigned>(r >> 20) % 100 < read_pct) {
+                if (!w.lru->get(key, value)) w.lru->put(key, r);
+            } else {
+                w.lru->put(key, r);
+            }
+            break;
+        }
+    }
+}
+
+void run_benchmark(Workload workload, lock_type_t type, int num_threads) {
+    Workloads w;
+    try {
+        switch (workload) {
+            case Workload::HashMap:
+                w.map = std::make_unique<ShardedHashMap>(type, g_buckets);
+                // Pre-populate half of the key space.
+                for (std::uint64_t k = 0; k < KEY_SPACE; k += 2) w.map->put(k, k);
+                break;
+            case Workload::Queue:
+                w.queue = std::make_unique<BoundedQueue>(type);
+                break;
+            case Workload::LruReadMostly:
+            case Workload::LruMixed:
+                w.lru = std::make_unique<LruCache>(type);
+                break;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Failed to create C++ lock: " << e.what() << std::endl;
+        return;
+    }
+
+    std::vector<std::vector<std::uint64_t> > samples(num_threads);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            auto &mine = samples[t];
+            mine.reserve(g_ops_per_thread / LATENCY_SAMPLE_EVERY + 1);
+            std::uint64_t rng = 0x2545F4914F6CDD1Dull ^ (static_cast<std::uint64_t>(t + 1) * 0x9E3779B97F4A7C15ull);
+            for (long i = 0; i < g_ops_per_thread; ++i) {
+                if (i % LATENCY_SAMPLE_EVERY == 0) {
+                    auto t0 = std::chrono::steady_clock::now();
+                    run_one_op(workload, w, rng, i);
+                    auto t1 = std::chrono::steady_clock::now();
+                    mine.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+                } else {
+                    run_one_op(workload, w, rng, i);
+                }
+            }
+        });
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end_time - start_time;
+
+    std::vector<std::uint64_t> all;
+    for (auto &s: samples) all.insert(all.end(), s.begin(), s.end());
+    std::sort(all.begin(), all.end());
+    auto pct = [&](std::size_t per_mille) { return all[all.size() * per_mille / 1000]; };
+    double mops = static_cast<double>(num_threads) * g_ops_per_thread / duration.count() / 1e6;
+
+    std::cout << "| " << std::left << std::setw(10) << workload_to_string(workload)
+              << " | " << std::setw(13) << lock_type_to_string(type)
+              << " | " << std::right << std::setw(3) << num_threads << " Threads"
+              << " | " << std::fixed << std::setprecision(3) << std::setw(8) << mops << " Mops/s"
+              << " | " << std::setw(8) << pct(500)
+              << " | " << std::setw(8) << pct(990)
+              << " | " << std::setw(9) << pct(999) << " |" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) g_buckets = std::atoi(argv[1]);
+    if (argc > 2) g_ops_per_thread = std::atol(argv[2]);
+    if (g_buckets <= 0) g_buckets = DEFAULT_BUCKETS;
+    if (g_ops_per_thread <= 0) g_ops_per_thread = DEFAULT_OPS_PER_THREAD;
+
+    unsigned int num_cores = std::thread::hardware_concurrency();
+    if (num_cores == 0) num_cores = 8;
+    std::cout << "--- C++ Lock Library Macro-Benchmark ---\n";
+    std::cout << "Detected " << num_cores << " logical cores. Hash map buckets: " << g_buckets
+              << ", ops/thread: " << g_ops_per_thread << ".\n";
+    std::cout << "Latencies are sampled every " << LATENCY_SAMPLE_EVERY << " ops and reported in ns.\n\n";
+
+    const char *rule = "+------------+---------------+-------------+-----------------+----------+----------+-----------+";
+    std::cout << rule << std::endl;
+    std::cout << "| Workload   | Lock Type     | Thread Count| Throughput      | p50      | p99      | p99.9     |" << std::endl;
+    std::cout << rule << std::endl;
+
+    const Workload workloads[] = {Workload::HashMap, Workload::Queue, Workload::LruReadMostly, Workload::LruMixed};
+    for (Workload workload: workloads) {
+        for (int type = LOCK_TYPE_PTHREAD_MUTEX; type <= LOCK_TYPE_BIASED_MCS; ++type) {
+            for (unsigned int threads = 1; threads <= num_cores * 2; threads *= 2) {
+                if (threads > MAX_THREADS) break;
+                run_benchmark(workload, static_cast<lock_type_t>(type), threads);
+            }
+        }
+        std::cout << rule << std::endl;
+    }
+    return 0;
+}